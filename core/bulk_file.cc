@@ -0,0 +1,124 @@
+//
+//  bulk_file.cc
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#include "bulk_file.h"
+#include "utils/files.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace ycsbc {
+
+namespace {
+
+const char kPartitionPrefix[] = "part-";
+const char kPartitionSuffix[] = ".ycsb";
+
+} // namespace
+
+void BulkFileWriter::Open(const std::string &path) {
+  path_ = path;
+  output_.open(path, std::ios::binary | std::ios::trunc);
+  if (!output_.is_open()) {
+    throw utils::Exception("failed to create: " + path);
+  }
+}
+
+void BulkFileWriter::PutString(const std::string &s) {
+  const uint32_t len = s.size();
+  output_.write(reinterpret_cast<const char *>(&len), sizeof(len));
+  output_.write(s.data(), s.size());
+}
+
+void BulkFileWriter::Add(const std::string &key, const std::vector<DB::Field> &values) {
+  PutString(key);
+  const uint32_t count = values.size();
+  output_.write(reinterpret_cast<const char *>(&count), sizeof(count));
+  for (const DB::Field &field : values) {
+    PutString(field.name);
+    PutString(field.value);
+  }
+}
+
+void BulkFileWriter::Close() {
+  output_.close();
+  if (output_.fail()) {
+    throw utils::Exception("failed to write: " + path_);
+  }
+}
+
+void BulkFileReader::Open(const std::string &path) {
+  path_ = path;
+  input_.open(path, std::ios::binary);
+  if (!input_.is_open()) {
+    throw utils::Exception("failed to open: " + path);
+  }
+}
+
+bool BulkFileReader::GetUint32(uint32_t *n) {
+  input_.read(reinterpret_cast<char *>(n), sizeof(*n));
+  return input_.gcount() == sizeof(*n);
+}
+
+void BulkFileReader::GetString(std::string &s) {
+  uint32_t len;
+  if (!GetUint32(&len)) {
+    throw utils::Exception("truncated record in " + path_);
+  }
+  s.resize(len);
+  input_.read(&s[0], len);
+  if (static_cast<uint32_t>(input_.gcount()) != len) {
+    throw utils::Exception("truncated record in " + path_);
+  }
+}
+
+bool BulkFileReader::Next(std::string &key, std::vector<DB::Field> &values) {
+  uint32_t len;
+  if (!GetUint32(&len)) {
+    return false;
+  }
+  key.resize(len);
+  input_.read(&key[0], len);
+  uint32_t count;
+  if (static_cast<uint32_t>(input_.gcount()) != len || !GetUint32(&count)) {
+    throw utils::Exception("truncated record in " + path_);
+  }
+  values.resize(count);
+  for (DB::Field &field : values) {
+    GetString(field.name);
+    GetString(field.value);
+  }
+  return true;
+}
+
+std::string BulkPartitionPath(const std::string &dir, int i) {
+  char name[32];
+  snprintf(name, sizeof(name), "%s%05d%s", kPartitionPrefix, i, kPartitionSuffix);
+  return dir + "/" + name;
+}
+
+std::vector<std::string> ListBulkPartitions(const std::string &dir) {
+  const std::string prefix = kPartitionPrefix;
+  const std::string suffix = kPartitionSuffix;
+  std::vector<std::string> paths;
+  for (const std::string &file : utils::ListFiles(dir)) {
+    if (file.size() > prefix.size() + suffix.size() && file.compare(0, prefix.size(), prefix) == 0 &&
+        file.compare(file.size() - suffix.size(), suffix.size(), suffix) == 0) {
+      paths.push_back(dir + "/" + file);
+    }
+  }
+  // zero-padded numbers, so name order is partition order
+  std::sort(paths.begin(), paths.end());
+  return paths;
+}
+
+std::string BulkManifestPath(const std::string &dir) {
+  return dir + "/MANIFEST.ycsb";
+}
+
+} // ycsbc
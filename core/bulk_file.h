@@ -0,0 +1,77 @@
+//
+//  bulk_file.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_BULK_FILE_H_
+#define YCSB_C_BULK_FILE_H_
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "db.h"
+
+namespace ycsbc {
+
+///
+/// A load dataset generated offline by ycsb-gen is a directory of partition
+/// files plus a manifest. Each partition holds records sorted by key, and
+/// every key of a partition is above the keys of the partitions before it,
+/// so reading the partitions in order gives all records in key order.
+///
+/// A record is its key and then its fields, each string preceded by its
+/// length as a 32-bit integer in host byte order:
+///
+///   key_len key field_count (name_len name value_len value)*
+///
+class BulkFileWriter {
+ public:
+  void Open(const std::string &path);
+  void Add(const std::string &key, const std::vector<DB::Field> &values);
+  void Close();
+
+ private:
+  void PutString(const std::string &s);
+
+  std::string path_;
+  std::ofstream output_;
+};
+
+class BulkFileReader {
+ public:
+  void Open(const std::string &path);
+  ///
+  /// Reads the next record. Returns false at the end of the file.
+  ///
+  bool Next(std::string &key, std::vector<DB::Field> &values);
+
+ private:
+  bool GetUint32(uint32_t *n);
+  void GetString(std::string &s);
+
+  std::string path_;
+  std::ifstream input_;
+};
+
+///
+/// Path of partition i of the dataset in dir.
+///
+std::string BulkPartitionPath(const std::string &dir, int i);
+
+///
+/// Paths of the partitions of the dataset in dir, in key order.
+///
+std::vector<std::string> ListBulkPartitions(const std::string &dir);
+
+///
+/// Path of the manifest of the dataset in dir, a properties file with the
+/// workload properties the dataset was generated with.
+///
+std::string BulkManifestPath(const std::string &dir);
+
+} // ycsbc
+
+#endif // YCSB_C_BULK_FILE_H_
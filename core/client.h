@@ -9,27 +9,39 @@
 #ifndef YCSB_C_CLIENT_H_
 #define YCSB_C_CLIENT_H_
 
+#include <atomic>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "db.h"
 #include "core_workload.h"
+#include "measurements.h"
+#include "utils/affinity.h"
 #include "utils/countdown_latch.h"
 #include "utils/rate_limit.h"
 #include "utils/utils.h"
 
 namespace ycsbc {
 
-inline int ClientThread(ycsbc::DB *db, ycsbc::CoreWorkload *wl, const int num_ops, bool is_loading,
-                        bool init_db, bool cleanup_db, utils::CountDownLatch *latch, utils::RateLimiter *rlim) {
+inline int ClientThread(ycsbc::DB *db, ycsbc::CoreWorkload *wl, ycsbc::Measurements *measurements,
+                        const int num_ops, bool is_loading, bool init_db, bool cleanup_db,
+                        utils::CountDownLatch *latch, utils::RateLimiter *rlim,
+                        const std::atomic<bool> *stop, std::vector<int> cpus) {
 
   try {
+    // pin before touching any per-thread state so that it is allocated node-locally
+    utils::SetThreadAffinity(cpus);
+
     if (init_db) {
       db->Init();
     }
 
     int ops = 0;
     for (int i = 0; i < num_ops; ++i) {
+      if (stop && stop->load(std::memory_order_relaxed)) {
+        break;
+      }
       if (rlim) {
         rlim->Consume(1);
       }
@@ -39,6 +51,7 @@ inline int ClientThread(ycsbc::DB *db, ycsbc::CoreWorkload *wl, const int num_op
       } else {
         wl->DoTransaction(*db);
       }
+      measurements->ReportClientOp();
       ops++;
     }
 
@@ -54,6 +67,32 @@ inline int ClientThread(ycsbc::DB *db, ycsbc::CoreWorkload *wl, const int num_op
   }
 }
 
+inline int VerifyThread(ycsbc::DB *db, ycsbc::CoreWorkload *wl, const int num_ops, bool init_db,
+                        bool cleanup_db, utils::CountDownLatch *latch, std::vector<int> cpus) {
+  try {
+    utils::SetThreadAffinity(cpus);
+
+    if (init_db) {
+      db->Init();
+    }
+
+    int ok = 0;
+    for (int i = 0; i < num_ops; ++i) {
+      ok += wl->DoVerify(*db);
+    }
+
+    if (cleanup_db) {
+      db->Cleanup();
+    }
+
+    latch->CountDown();
+    return ok;
+  } catch (const utils::Exception &e) {
+    std::cerr << "Caught exception: " << e.what() << std::endl;
+    exit(1);
+  }
+}
+
 } // ycsbc
 
 #endif // YCSB_C_CLIENT_H_
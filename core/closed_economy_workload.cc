@@ -0,0 +1,176 @@
+//
+//  closed_economy_workload.cc
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#include "closed_economy_workload.h"
+#include "measurements.h"
+#include "utils/timer.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace ycsbc {
+
+const std::string ClosedEconomyWorkload::INITIAL_BALANCE_PROPERTY = "closedeconomy.initialbalance";
+const std::string ClosedEconomyWorkload::INITIAL_BALANCE_DEFAULT = "1000";
+
+const std::string ClosedEconomyWorkload::MAX_TRANSFER_PROPERTY = "closedeconomy.maxtransfer";
+const std::string ClosedEconomyWorkload::MAX_TRANSFER_DEFAULT = "100";
+
+const std::string ClosedEconomyWorkload::MAX_RETRIES_PROPERTY = "closedeconomy.maxretries";
+const std::string ClosedEconomyWorkload::MAX_RETRIES_DEFAULT = "10";
+
+void ClosedEconomyWorkload::Init(const utils::Properties &p) {
+  CoreWorkload::Init(p);
+  if (data_integrity_) {
+    throw utils::Exception(DATA_INTEGRITY_PROPERTY + " is not supported by the closedeconomy workload");
+  }
+
+  initial_balance_ = std::stoll(p.GetProperty(INITIAL_BALANCE_PROPERTY, INITIAL_BALANCE_DEFAULT));
+  max_transfer_ = std::stoll(p.GetProperty(MAX_TRANSFER_PROPERTY, MAX_TRANSFER_DEFAULT));
+  max_retries_ = std::stoi(p.GetProperty(MAX_RETRIES_PROPERTY, MAX_RETRIES_DEFAULT));
+  if (record_count_ < 2 || initial_balance_ < 0 || max_transfer_ <= 0 || max_retries_ < 0) {
+    throw utils::Exception("Invalid closedeconomy parameters");
+  }
+}
+
+void ClosedEconomyWorkload::BuildAccount(int64_t balance, std::vector<DB::Field> &values) {
+  BuildValues(values);
+  values[0].value = std::to_string(balance);
+}
+
+DB::Field *ClosedEconomyWorkload::BalanceField(std::vector<DB::Field> &values) {
+  const std::string balance_field = field_prefix_ + "0";
+  for (auto &field : values) {
+    if (field.name == balance_field) {
+      return &field;
+    }
+  }
+  return nullptr;
+}
+
+bool ClosedEconomyWorkload::DoInsert(DB &db) {
+  const std::string key = BuildKeyName(insert_key_sequence_->Next());
+  std::vector<DB::Field> values;
+  BuildAccount(initial_balance_, values);
+  return db.Insert(table_name_, key, values) == DB::kOK;
+}
+
+bool ClosedEconomyWorkload::DoTransaction(DB &db) {
+  utils::Timer<uint64_t, std::nano> timer;
+  timer.Start();
+
+  const uint64_t from = NextTransactionKeyNum();
+  uint64_t to;
+  do {
+    to = NextTransactionKeyNum();
+  } while (to == from);
+  const std::string from_key = BuildKeyName(from);
+  const std::string to_key = BuildKeyName(to);
+
+  utils::Timer<uint64_t, std::nano> attempt_timer;
+  for (int attempt = 0; ; attempt++) {
+    attempt_timer.Start();
+    std::unique_ptr<DB::Transaction> txn(db.BeginTransaction(table_name_));
+    if (txn == nullptr) {
+      throw utils::Exception("closedeconomy workload needs a database with transactions");
+    }
+
+    DB::Status s = Transfer(*txn, from_key, to_key);
+    if (s == DB::kOK) {
+      commits_.fetch_add(1, std::memory_order_relaxed);
+      measurements_->Report(TRANSACTION, timer.End());
+      return true;
+    } else if (s != DB::kAborted) {
+      return false;
+    }
+
+    aborts_.fetch_add(1, std::memory_order_relaxed);
+    measurements_->Report(TRANSACTION_ABORTED, attempt_timer.End());
+    if (attempt >= max_retries_) {
+      gave_up_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    retries_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+DB::Status ClosedEconomyWorkload::Transfer(DB::Transaction &txn, const std::string &from,
+                                           const std::string &to) {
+  std::vector<DB::Field> from_values;
+  std::vector<DB::Field> to_values;
+  DB::Field *from_balance = nullptr;
+  DB::Field *to_balance = nullptr;
+
+  DB::Status s = txn.Read(from, NULL, from_values);
+  if (s == DB::kOK) {
+    s = txn.Read(to, NULL, to_values);
+  }
+  if (s == DB::kOK) {
+    from_balance = BalanceField(from_values);
+    to_balance = BalanceField(to_values);
+    if (from_balance == nullptr || to_balance == nullptr) {
+      s = DB::kError;
+    }
+  }
+  if (s != DB::kOK) {
+    txn.Rollback();
+    return s;
+  }
+
+  // never overdraw, so that balances stay non-negative
+  const int64_t balance = std::stoll(from_balance->value);
+  const int64_t amount = std::min<int64_t>(balance,
+      static_cast<int64_t>(utils::ThreadLocalRandomDouble(1, max_transfer_ + 1)));
+  from_balance->value = std::to_string(balance - amount);
+  to_balance->value = std::to_string(std::stoll(to_balance->value) + amount);
+
+  s = txn.Write(from, from_values);
+  if (s == DB::kOK) {
+    s = txn.Write(to, to_values);
+  }
+  if (s != DB::kOK) {
+    txn.Rollback();
+    return s;
+  }
+  return txn.Commit();
+}
+
+void ClosedEconomyWorkload::FinishRun(DB &db) {
+  const uint64_t commits = commits_.exchange(0);
+  const uint64_t aborts = aborts_.exchange(0);
+  const uint64_t retries = retries_.exchange(0);
+  const uint64_t gave_up = gave_up_.exchange(0);
+  std::cout << "Transactions: commits=" << commits << " aborts=" << aborts
+            << " abort rate(%)=" << (commits + aborts > 0 ? 100.0 * aborts / (commits + aborts) : 0)
+            << " retries=" << retries << " gave up=" << gave_up << std::endl;
+
+  // no transfer runs now, so the accounts must add up to what was loaded
+  const uint64_t accounts = GetRecordCount();
+  int64_t total = 0;
+  uint64_t missing = 0;
+  for (uint64_t i = 0; i < accounts; i++) {
+    std::vector<DB::Field> values;
+    DB::Field *balance = nullptr;
+    if (db.Read(table_name_, BuildKeyName(i), NULL, values) == DB::kOK) {
+      balance = BalanceField(values);
+    }
+    if (balance == nullptr) {
+      missing++;
+      continue;
+    }
+    total += std::stoll(balance->value);
+  }
+  const int64_t expected = static_cast<int64_t>(accounts) * initial_balance_;
+  std::cout << "Invariant check: accounts=" << accounts << " missing=" << missing
+            << " total balance=" << total << " expected=" << expected
+            << (total == expected && missing == 0 ? " OK" : " VIOLATED") << std::endl;
+}
+
+} // ycsbc
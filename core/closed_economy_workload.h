@@ -0,0 +1,79 @@
+//
+//  closed_economy_workload.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_CLOSED_ECONOMY_WORKLOAD_H_
+#define YCSB_C_CLOSED_ECONOMY_WORKLOAD_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "core_workload.h"
+#include "db.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Closed-economy transactional workload in the style of YCSB+T. Every
+/// record is an account whose balance is kept in the first field. A
+/// transaction reads two accounts and moves money from one to the other in
+/// a DB transaction, so the total balance never changes if the database
+/// isolates transactions correctly. Transactions aborted by a conflict are
+/// retried; the end of the run reports commits, aborts and retries, and
+/// checks that the total balance was conserved.
+///
+/// requestdistribution picks the accounts, so a skewed distribution raises
+/// contention. The database must support DB::BeginTransaction.
+///
+class ClosedEconomyWorkload : public CoreWorkload {
+ public:
+  ///
+  /// The name of the property for the balance of each account at load.
+  ///
+  static const std::string INITIAL_BALANCE_PROPERTY;
+  static const std::string INITIAL_BALANCE_DEFAULT;
+
+  ///
+  /// The name of the property for the largest amount moved by a transfer.
+  ///
+  static const std::string MAX_TRANSFER_PROPERTY;
+  static const std::string MAX_TRANSFER_DEFAULT;
+
+  ///
+  /// The name of the property for how many times an aborted transfer is
+  /// retried before it is given up.
+  ///
+  static const std::string MAX_RETRIES_PROPERTY;
+  static const std::string MAX_RETRIES_DEFAULT;
+
+  void Init(const utils::Properties &p) override;
+
+  bool DoInsert(DB &db) override;
+  bool DoTransaction(DB &db) override;
+  void FinishRun(DB &db) override;
+
+  ClosedEconomyWorkload() : initial_balance_(0), max_transfer_(0), max_retries_(0),
+                            commits_(0), aborts_(0), retries_(0), gave_up_(0) {}
+
+ private:
+  DB::Field *BalanceField(std::vector<DB::Field> &values);
+  void BuildAccount(int64_t balance, std::vector<DB::Field> &values);
+  DB::Status Transfer(DB::Transaction &txn, const std::string &from, const std::string &to);
+
+  int64_t initial_balance_;
+  int64_t max_transfer_;
+  int max_retries_;
+  std::atomic<uint64_t> commits_;
+  std::atomic<uint64_t> aborts_;
+  std::atomic<uint64_t> retries_;
+  std::atomic<uint64_t> gave_up_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_CLOSED_ECONOMY_WORKLOAD_H_
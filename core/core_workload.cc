@@ -11,13 +11,26 @@
 #include "zipfian_generator.h"
 #include "scrambled_zipfian_generator.h"
 #include "skewed_latest_generator.h"
+#include "hotspot_generator.h"
+#include "moving_hotspot_generator.h"
+#include "exponential_generator.h"
+#include "sequential_generator.h"
 #include "const_generator.h"
+#include "closed_economy_workload.h"
 #include "core_workload.h"
+#include "graph_workload.h"
+#include "measurements.h"
+#include "multi_table_workload.h"
+#include "queue_workload.h"
 #include "random_byte_generator.h"
+#include "timeseries_workload.h"
+#include "utils/timer.h"
 #include "utils/utils.h"
 
 #include <algorithm>
+#include <iostream>
 #include <random>
+#include <sstream>
 #include <string>
 
 using ycsbc::CoreWorkload;
@@ -30,17 +43,37 @@ const char *ycsbc::kOperationString[ycsbc::MAXOPTYPE] = {
   "SCAN",
   "READMODIFYWRITE",
   "DELETE",
+  "BATCH-WRITE",
   "INSERT-FAILED",
   "READ-FAILED",
   "UPDATE-FAILED",
   "SCAN-FAILED",
   "READMODIFYWRITE-FAILED",
-  "DELETE-FAILED"
+  "DELETE-FAILED",
+  "BATCH-WRITE-FAILED",
+  "ENQUEUE",
+  "DEQUEUE",
+  "MESSAGE-AGE",
+  "APPEND-POINTS",
+  "QUERY-WINDOW",
+  "GET-NODE",
+  "ADD-LINK",
+  "DELETE-LINK",
+  "COUNT-LINKS",
+  "GET-LINK-RANGE",
+  "TRANSACTION",
+  "TRANSACTION-ABORTED",
+  "VERIFY"
 };
 
+const string CoreWorkload::WORKLOAD_PROPERTY = "workload";
+const string CoreWorkload::WORKLOAD_DEFAULT = "com.yahoo.ycsb.workloads.CoreWorkload";
+
 const string CoreWorkload::TABLENAME_PROPERTY = "table";
 const string CoreWorkload::TABLENAME_DEFAULT = "usertable";
 
+const string CoreWorkload::TABLES_PROPERTY = "tables";
+
 const string CoreWorkload::FIELD_COUNT_PROPERTY = "fieldcount";
 const string CoreWorkload::FIELD_COUNT_DEFAULT = "10";
 
@@ -71,9 +104,36 @@ const string CoreWorkload::SCAN_PROPORTION_DEFAULT = "0.0";
 const string CoreWorkload::READMODIFYWRITE_PROPORTION_PROPERTY = "readmodifywriteproportion";
 const string CoreWorkload::READMODIFYWRITE_PROPORTION_DEFAULT = "0.0";
 
+const string CoreWorkload::DELETE_PROPORTION_PROPERTY = "deleteproportion";
+const string CoreWorkload::DELETE_PROPORTION_DEFAULT = "0.0";
+
+const string CoreWorkload::DELETED_ACCESS_PROPORTION_PROPERTY = "deletedaccessproportion";
+const string CoreWorkload::DELETED_ACCESS_PROPORTION_DEFAULT = "0.0";
+
+const string CoreWorkload::LOST_UPDATE_CHECK_PROPERTY = "lostupdatecheck";
+const string CoreWorkload::LOST_UPDATE_CHECK_DEFAULT = "false";
+
+const string CoreWorkload::DATA_INTEGRITY_PROPERTY = "dataintegrity";
+const string CoreWorkload::DATA_INTEGRITY_DEFAULT = "false";
+
 const string CoreWorkload::REQUEST_DISTRIBUTION_PROPERTY = "requestdistribution";
 const string CoreWorkload::REQUEST_DISTRIBUTION_DEFAULT = "uniform";
 
+const string CoreWorkload::HOTSPOT_DATA_FRACTION_PROPERTY = "hotspotdatafraction";
+const string CoreWorkload::HOTSPOT_DATA_FRACTION_DEFAULT = "0.2";
+
+const string CoreWorkload::HOTSPOT_OPN_FRACTION_PROPERTY = "hotspotopnfraction";
+const string CoreWorkload::HOTSPOT_OPN_FRACTION_DEFAULT = "0.8";
+
+const string CoreWorkload::MOVING_HOTSPOT_SPEED_PROPERTY = "movinghotspot.speed";
+const string CoreWorkload::MOVING_HOTSPOT_SPEED_DEFAULT = "1000";
+
+const string CoreWorkload::EXPONENTIAL_PERCENTILE_PROPERTY = "exponential.percentile";
+const string CoreWorkload::EXPONENTIAL_PERCENTILE_DEFAULT = "95";
+
+const string CoreWorkload::EXPONENTIAL_FRAC_PROPERTY = "exponential.frac";
+const string CoreWorkload::EXPONENTIAL_FRAC_DEFAULT = "0.8571428571";
+
 const string CoreWorkload::ZERO_PADDING_PROPERTY = "zeropadding";
 const string CoreWorkload::ZERO_PADDING_DEFAULT = "1";
 
@@ -92,6 +152,9 @@ const string CoreWorkload::INSERT_ORDER_DEFAULT = "hashed";
 const string CoreWorkload::INSERT_START_PROPERTY = "insertstart";
 const string CoreWorkload::INSERT_START_DEFAULT = "0";
 
+const string CoreWorkload::KEY_PREFIX_PROPERTY = "keyprefix";
+const string CoreWorkload::KEY_PREFIX_DEFAULT = "user";
+
 const string CoreWorkload::RECORD_COUNT_PROPERTY = "recordcount";
 const string CoreWorkload::OPERATION_COUNT_PROPERTY = "operationcount";
 
@@ -100,6 +163,20 @@ const std::string CoreWorkload::FIELD_NAME_PREFIX_DEFAULT = "field";
 
 const std::string CoreWorkload::ZIPFIAN_CONST_PROPERTY = "zipfian_const";
 
+namespace {
+
+// marks a counter written by a read-modify-write, so that loaded values are not mistaken for one
+const std::string kCounterPrefix = "rmw:";
+
+uint64_t ParseCounter(const std::vector<ycsbc::DB::Field> &result) {
+  if (result.empty() || result[0].value.compare(0, kCounterPrefix.size(), kCounterPrefix) != 0) {
+    return 0;
+  }
+  return std::stoull(result[0].value.substr(kCounterPrefix.size()));
+}
+
+} // namespace
+
 namespace ycsbc {
 
 void CoreWorkload::Init(const utils::Properties &p) {
@@ -119,17 +196,43 @@ void CoreWorkload::Init(const utils::Properties &p) {
                                                    SCAN_PROPORTION_DEFAULT));
   double readmodifywrite_proportion = std::stod(p.GetProperty(
       READMODIFYWRITE_PROPORTION_PROPERTY, READMODIFYWRITE_PROPORTION_DEFAULT));
+  double delete_proportion = std::stod(p.GetProperty(DELETE_PROPORTION_PROPERTY,
+                                                     DELETE_PROPORTION_DEFAULT));
+  deleted_access_proportion_ = std::stod(p.GetProperty(DELETED_ACCESS_PROPORTION_PROPERTY,
+                                                       DELETED_ACCESS_PROPORTION_DEFAULT));
 
   record_count_ = std::stoi(p.GetProperty(RECORD_COUNT_PROPERTY));
+  lost_update_check_ = (p.GetProperty(LOST_UPDATE_CHECK_PROPERTY, LOST_UPDATE_CHECK_DEFAULT) == "true");
+  if (lost_update_check_) {
+    if (update_proportion > 0 || delete_proportion > 0) {
+      throw utils::Exception(LOST_UPDATE_CHECK_PROPERTY + " cannot be combined with updates or deletes");
+    }
+    rmw_counts_.reset(new std::atomic<uint32_t>[record_count_]());
+  }
+  data_integrity_ = utils::StrToBool(p.GetProperty(DATA_INTEGRITY_PROPERTY, DATA_INTEGRITY_DEFAULT));
+  if (data_integrity_) {
+    if (lost_update_check_) {
+      throw utils::Exception(DATA_INTEGRITY_PROPERTY + " cannot be combined with " + LOST_UPDATE_CHECK_PROPERTY);
+    }
+    if (p.GetProperty(FIELD_LENGTH_DISTRIBUTION_PROPERTY, FIELD_LENGTH_DISTRIBUTION_DEFAULT) != "constant") {
+      throw utils::Exception(DATA_INTEGRITY_PROPERTY + " needs a constant field length");
+    }
+    // room for the longest version and its separator
+    field_length_ = std::stoi(p.GetProperty(FIELD_LENGTH_PROPERTY, FIELD_LENGTH_DEFAULT));
+    if (field_length_ < 21) {
+      throw utils::Exception(DATA_INTEGRITY_PROPERTY + " needs a field length of at least 21");
+    }
+  }
   std::string request_dist = p.GetProperty(REQUEST_DISTRIBUTION_PROPERTY,
                                            REQUEST_DISTRIBUTION_DEFAULT);
   int min_scan_len = std::stoi(p.GetProperty(MIN_SCAN_LENGTH_PROPERTY, MIN_SCAN_LENGTH_DEFAULT));
   int max_scan_len = std::stoi(p.GetProperty(MAX_SCAN_LENGTH_PROPERTY, MAX_SCAN_LENGTH_DEFAULT));
   std::string scan_len_dist = p.GetProperty(SCAN_LENGTH_DISTRIBUTION_PROPERTY,
                                             SCAN_LENGTH_DISTRIBUTION_DEFAULT);
-  int insert_start = std::stoi(p.GetProperty(INSERT_START_PROPERTY, INSERT_START_DEFAULT));
+  insert_start_ = std::stoull(p.GetProperty(INSERT_START_PROPERTY, INSERT_START_DEFAULT));
 
   zero_padding_ = std::stoi(p.GetProperty(ZERO_PADDING_PROPERTY, ZERO_PADDING_DEFAULT));
+  key_prefix_ = p.GetProperty(KEY_PREFIX_PROPERTY, KEY_PREFIX_DEFAULT);
 
   read_all_fields_ = utils::StrToBool(p.GetProperty(READ_ALL_FIELDS_PROPERTY,
                                                     READ_ALL_FIELDS_DEFAULT));
@@ -158,9 +261,13 @@ void CoreWorkload::Init(const utils::Properties &p) {
   if (readmodifywrite_proportion > 0) {
     op_chooser_.AddValue(READMODIFYWRITE, readmodifywrite_proportion);
   }
+  if (delete_proportion > 0) {
+    op_chooser_.AddValue(DELETE, delete_proportion);
+    live_keys_ = new LiveKeySet();
+  }
 
-  insert_key_sequence_ = new CounterGenerator(insert_start);
-  transaction_insert_key_sequence_ = new AcknowledgedCounterGenerator(record_count_);
+  insert_key_sequence_ = new CounterGenerator(insert_start_);
+  transaction_insert_key_sequence_ = new AcknowledgedCounterGenerator(TransactionInsertStart(p));
 
   if (request_dist == "uniform") {
     key_chooser_ = new UniformGenerator(0, record_count_ - 1);
@@ -181,6 +288,31 @@ void CoreWorkload::Init(const utils::Properties &p) {
     }
   } else if (request_dist == "latest") {
     key_chooser_ = new SkewedLatestGenerator(*transaction_insert_key_sequence_);
+
+  } else if (request_dist == "hotspot" || request_dist == "movinghotspot") {
+    double hot_data = std::stod(p.GetProperty(HOTSPOT_DATA_FRACTION_PROPERTY, HOTSPOT_DATA_FRACTION_DEFAULT));
+    double hot_opn = std::stod(p.GetProperty(HOTSPOT_OPN_FRACTION_PROPERTY, HOTSPOT_OPN_FRACTION_DEFAULT));
+    if (hot_data < 0 || hot_data > 1 || hot_opn < 0 || hot_opn > 1) {
+      throw utils::Exception("Invalid hotspot fractions");
+    }
+    if (request_dist == "hotspot") {
+      key_chooser_ = new HotspotGenerator(0, record_count_ - 1, hot_data, hot_opn);
+    } else {
+      double speed = std::stod(p.GetProperty(MOVING_HOTSPOT_SPEED_PROPERTY, MOVING_HOTSPOT_SPEED_DEFAULT));
+      key_chooser_ = new MovingHotspotGenerator(0, record_count_ - 1, hot_data, hot_opn, speed);
+    }
+
+  } else if (request_dist == "exponential") {
+    double percentile = std::stod(p.GetProperty(EXPONENTIAL_PERCENTILE_PROPERTY, EXPONENTIAL_PERCENTILE_DEFAULT));
+    double frac = std::stod(p.GetProperty(EXPONENTIAL_FRAC_PROPERTY, EXPONENTIAL_FRAC_DEFAULT));
+    if (percentile <= 0 || percentile >= 100 || frac <= 0) {
+      throw utils::Exception("Invalid exponential parameters");
+    }
+    key_chooser_ = new ExponentialGenerator(*transaction_insert_key_sequence_, percentile,
+                                            record_count_ * frac);
+
+  } else if (request_dist == "sequential") {
+    key_chooser_ = new SequentialGenerator(0, record_count_ - 1);
   } else {
     throw utils::Exception("Unknown request distribution: " + request_dist);
   }
@@ -216,7 +348,7 @@ std::string CoreWorkload::BuildKeyName(uint64_t key_num) {
   if (!ordered_inserts_) {
     key_num = utils::Hash(key_num);
   }
-  std::string prekey = "user";
+  std::string prekey = key_prefix_;
   std::string value = std::to_string(key_num);
   int fill = std::max(0, zero_padding_ - static_cast<int>(value.size()));
   return prekey.append(fill, '0').append(value);
@@ -244,6 +376,63 @@ void CoreWorkload::BuildSingleValue(std::vector<ycsbc::DB::Field> &values) {
   std::generate_n(std::back_inserter(field.value), len, [&]() { return byte_generator.Next(); } );
 }
 
+void CoreWorkload::BuildValues(uint64_t key_num, std::vector<ycsbc::DB::Field> &values) {
+  if (!data_integrity_) {
+    BuildValues(values);
+    return;
+  }
+  // the fields of one write share a version
+  const uint64_t version = write_version_.fetch_add(1, std::memory_order_relaxed);
+  for (int i = 0; i < field_count_; ++i) {
+    values.push_back(DB::Field());
+    ycsbc::DB::Field &field = values.back();
+    field.name.append(field_prefix_).append(std::to_string(i));
+    field.value = BuildDeterministicValue(key_num, field.name, version);
+  }
+}
+
+void CoreWorkload::BuildSingleValue(uint64_t key_num, std::vector<ycsbc::DB::Field> &values) {
+  if (!data_integrity_) {
+    BuildSingleValue(values);
+    return;
+  }
+  const uint64_t version = write_version_.fetch_add(1, std::memory_order_relaxed);
+  values.push_back(DB::Field());
+  ycsbc::DB::Field &field = values.back();
+  field.name.append(NextFieldName());
+  field.value = BuildDeterministicValue(key_num, field.name, version);
+}
+
+std::string CoreWorkload::BuildDeterministicValue(uint64_t key_num, const std::string &field,
+                                                  uint64_t version) {
+  std::string value = std::to_string(version);
+  value.push_back(':');
+  value.reserve(field_length_);
+  uint64_t seed = utils::Hash(key_num);
+  for (char c : field) {
+    seed = utils::Hash(seed ^ static_cast<unsigned char>(c));
+  }
+  seed = utils::Hash(seed ^ version);
+  while (value.size() < field_length_) {
+    // printable bytes, like RandomByteGenerator
+    seed = utils::Hash(seed);
+    for (int i = 0; i < 8 && value.size() < field_length_; i++) {
+      value.push_back(static_cast<char>(' ' + ((seed >> (i * 8)) & 0xff) % 95));
+    }
+  }
+  return value;
+}
+
+bool CoreWorkload::VerifyValue(uint64_t key_num, const DB::Field &field) {
+  const size_t sep = field.value.find(':');
+  if (sep == 0 || sep == std::string::npos || sep > 20 ||
+      field.value.find_first_not_of("0123456789") != sep) {
+    return false;
+  }
+  const uint64_t version = std::stoull(field.value.substr(0, sep));
+  return field.value == BuildDeterministicValue(key_num, field.name, version);
+}
+
 uint64_t CoreWorkload::NextTransactionKeyNum() {
   uint64_t key_num;
   do {
@@ -252,15 +441,40 @@ uint64_t CoreWorkload::NextTransactionKeyNum() {
   return key_num;
 }
 
+uint64_t CoreWorkload::NextAccessKeyNum() {
+  if (live_keys_ == nullptr) {
+    return NextTransactionKeyNum();
+  }
+  return NextTransactionKeyNum(utils::ThreadLocalRandomDouble() >= deleted_access_proportion_);
+}
+
+uint64_t CoreWorkload::NextTransactionKeyNum(bool live) {
+  // give up after a while so that a mostly live or mostly deleted key space
+  // does not stall the client, the request then hits whatever was picked last
+  const int kMaxAttempts = 100;
+  uint64_t key_num = NextTransactionKeyNum();
+  for (int i = 1; i < kMaxAttempts && live_keys_->IsLive(key_num) != live; i++) {
+    key_num = NextTransactionKeyNum();
+  }
+  return key_num;
+}
+
 std::string CoreWorkload::NextFieldName() {
   return std::string(field_prefix_).append(std::to_string(field_chooser_->Next()));
 }
 
 bool CoreWorkload::DoInsert(DB &db) {
-  const std::string key = BuildKeyName(insert_key_sequence_->Next());
+  const uint64_t key_num = insert_key_sequence_->Next();
+  const std::string key = BuildKeyName(key_num);
   std::vector<DB::Field> fields;
-  BuildValues(fields);
-  return db.Insert(table_name_, key, fields) == DB::kOK;
+  BuildValues(key_num, fields);
+  if (db.Insert(table_name_, key, fields) != DB::kOK) {
+    return false;
+  }
+  if (key_num < insert_acks_size_) {
+    insert_acks_[key_num].store(1, std::memory_order_release);
+  }
+  return true;
 }
 
 bool CoreWorkload::DoTransaction(DB &db) {
@@ -281,6 +495,9 @@ bool CoreWorkload::DoTransaction(DB &db) {
     case READMODIFYWRITE:
       status = TransactionReadModifyWrite(db);
       break;
+    case DELETE:
+      status = TransactionDelete(db);
+      break;
     default:
       throw utils::Exception("Operation request is not recognized!");
   }
@@ -288,7 +505,7 @@ bool CoreWorkload::DoTransaction(DB &db) {
 }
 
 DB::Status CoreWorkload::TransactionRead(DB &db) {
-  uint64_t key_num = NextTransactionKeyNum();
+  uint64_t key_num = NextAccessKeyNum();
   const std::string key = BuildKeyName(key_num);
   std::vector<DB::Field> result;
   if (!read_all_fields()) {
@@ -301,29 +518,125 @@ DB::Status CoreWorkload::TransactionRead(DB &db) {
 }
 
 DB::Status CoreWorkload::TransactionReadModifyWrite(DB &db) {
-  uint64_t key_num = NextTransactionKeyNum();
+  uint64_t key_num = NextAccessKeyNum();
+  if (lost_update_check_) {
+    return CountedReadModifyWrite(db, key_num);
+  }
   const std::string key = BuildKeyName(key_num);
   std::vector<DB::Field> result;
 
+  auto modify = [this, key_num](const std::vector<DB::Field> &result, std::vector<DB::Field> &values) {
+    if (write_all_fields()) {
+      BuildValues(key_num, values);
+    } else {
+      BuildSingleValue(key_num, values);
+    }
+  };
   if (!read_all_fields()) {
     std::vector<std::string> fields;
     fields.push_back(NextFieldName());
-    db.Read(table_name_, key, &fields, result);
+    return db.ReadModifyWrite(table_name_, key, &fields, result, modify);
   } else {
-    db.Read(table_name_, key, NULL, result);
+    return db.ReadModifyWrite(table_name_, key, NULL, result, modify);
   }
+}
 
-  std::vector<DB::Field> values;
-  if (write_all_fields()) {
-    BuildValues(values);
-  } else {
-    BuildSingleValue(values);
+DB::Status CoreWorkload::CountedReadModifyWrite(DB &db, uint64_t key_num) {
+  const std::string counter_field = field_prefix_ + "0";
+  std::vector<std::string> fields{counter_field};
+  std::vector<DB::Field> result;
+  DB::Status s = db.ReadModifyWrite(table_name_, BuildKeyName(key_num), &fields, result,
+      [&counter_field](const std::vector<DB::Field> &result, std::vector<DB::Field> &values) {
+        values.push_back({counter_field, kCounterPrefix + std::to_string(ParseCounter(result) + 1)});
+      });
+  // keys inserted during the run are not tracked
+  if (s == DB::kOK && key_num < record_count_) {
+    rmw_counts_[key_num].fetch_add(1, std::memory_order_relaxed);
   }
-  return db.Update(table_name_, key, values);
+  return s;
+}
+
+void CoreWorkload::FinishRun(DB &db) {
+  if (!lost_update_check_) {
+    return;
+  }
+  const std::string counter_field = field_prefix_ + "0";
+  std::vector<std::string> fields{counter_field};
+  uint64_t increments = 0;
+  uint64_t lost = 0;
+  uint64_t lost_keys = 0;
+  for (uint64_t i = 0; i < record_count_; i++) {
+    const uint64_t expected = rmw_counts_[i].load();
+    if (expected == 0) {
+      continue;
+    }
+    std::vector<DB::Field> result;
+    db.Read(table_name_, BuildKeyName(i), &fields, result);
+    const uint64_t counter = ParseCounter(result);
+    increments += expected;
+    if (counter < expected) {
+      lost += expected - counter;
+      lost_keys++;
+    }
+  }
+  std::cout << "Lost update check: increments=" << increments << " lost=" << lost
+            << " keys with lost updates=" << lost_keys << std::endl;
+}
+
+DB::Status CoreWorkload::VerifyRecord(DB &db, uint64_t key_num) {
+  std::vector<DB::Field> result;
+  DB::Status s = db.Read(table_name_, BuildKeyName(key_num), NULL, result);
+  if (s == DB::kNotFound) {
+    return s;
+  }
+  bool ok = (s == DB::kOK && result.size() == static_cast<size_t>(field_count_));
+  for (size_t i = 0; ok && i < result.size(); i++) {
+    ok = VerifyValue(key_num, result[i]);
+  }
+  return ok ? DB::kOK : DB::kError;
+}
+
+bool CoreWorkload::DoVerify(DB &db) {
+  utils::Timer<uint64_t, std::nano> timer;
+  timer.Start();
+  const uint64_t key_num = insert_start_ + verify_sequence_.fetch_add(1, std::memory_order_relaxed);
+  // records deleted by this process are expected to be gone
+  if (live_keys_ != nullptr && !live_keys_->IsLive(key_num)) {
+    verify_deleted_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  DB::Status s = VerifyRecord(db, key_num);
+  if (s == DB::kNotFound) {
+    verify_missing_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  } else if (s != DB::kOK) {
+    verify_corrupt_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  verify_ok_.fetch_add(1, std::memory_order_relaxed);
+  measurements_->Report(VERIFY, timer.End());
+  return true;
+}
+
+bool CoreWorkload::FinishVerify() {
+  const uint64_t ok = verify_ok_.exchange(0);
+  const uint64_t deleted = verify_deleted_.exchange(0);
+  const uint64_t missing = verify_missing_.exchange(0);
+  const uint64_t corrupt = verify_corrupt_.exchange(0);
+  verify_sequence_.store(0);
+  std::cout << "Verify " << table_name_ << ": records=" << ok + deleted + missing + corrupt << " ok=" << ok
+            << " deleted=" << deleted << " missing=" << missing << " corrupt=" << corrupt
+            << (missing + corrupt == 0 ? " OK" : " FAILED") << std::endl;
+  return missing + corrupt == 0;
+}
+
+void CoreWorkload::SaveState(utils::Properties &state) {
+  // the key sequences, the zipfian keyspace and "latest" all start from here
+  state.SetProperty(RECORD_COUNT_PROPERTY, std::to_string(GetRecordCount()));
 }
 
 DB::Status CoreWorkload::TransactionScan(DB &db) {
-  uint64_t key_num = NextTransactionKeyNum();
+  uint64_t key_num = NextAccessKeyNum();
   const std::string key = BuildKeyName(key_num);
   int len = scan_len_chooser_->Next();
   std::vector<std::vector<DB::Field>> result;
@@ -337,13 +650,13 @@ DB::Status CoreWorkload::TransactionScan(DB &db) {
 }
 
 DB::Status CoreWorkload::TransactionUpdate(DB &db) {
-  uint64_t key_num = NextTransactionKeyNum();
+  uint64_t key_num = NextAccessKeyNum();
   const std::string key = BuildKeyName(key_num);
   std::vector<DB::Field> values;
   if (write_all_fields()) {
-    BuildValues(values);
+    BuildValues(key_num, values);
   } else {
-    BuildSingleValue(values);
+    BuildSingleValue(key_num, values);
   }
   return db.Update(table_name_, key, values);
 }
@@ -352,10 +665,90 @@ DB::Status CoreWorkload::TransactionInsert(DB &db) {
   uint64_t key_num = transaction_insert_key_sequence_->Next();
   const std::string key = BuildKeyName(key_num);
   std::vector<DB::Field> values;
-  BuildValues(values);
+  BuildValues(key_num, values);
   DB::Status s = db.Insert(table_name_, key, values);
+  if (s == DB::kOK && key_num < insert_acks_size_) {
+    insert_acks_[key_num].store(1, std::memory_order_release);
+  }
   transaction_insert_key_sequence_->Acknowledge(key_num);
   return s;
 }
 
+DB::Status CoreWorkload::TransactionDelete(DB &db) {
+  // claim the key first so that concurrent deletes do not pick the same one
+  const int kMaxAttempts = 100;
+  for (int i = 0; i < kMaxAttempts; i++) {
+    const uint64_t key_num = NextTransactionKeyNum(true);
+    if (live_keys_->MarkDeleted(key_num)) {
+      // a crash test must not expect the record any more, whether or not
+      // the delete survives
+      if (key_num < insert_acks_size_) {
+        insert_acks_[key_num].store(0, std::memory_order_release);
+      }
+      DB::Status s = db.Delete(table_name_, BuildKeyName(key_num));
+      if (s == DB::kOK) {
+        deleted_records_.fetch_add(1, std::memory_order_relaxed);
+      } else if (s != DB::kNotFound) {
+        // the record is still there, so release the claim
+        live_keys_->MarkLive(key_num);
+      }
+      return s;
+    }
+  }
+  // every key picked is deleted already or being deleted by another client
+  return DB::kNotFound;
+}
+
+std::vector<std::string> CoreWorkload::GetTableNames(const utils::Properties &p) {
+  std::vector<std::string> tables;
+  std::stringstream ss(p.GetProperty(TABLES_PROPERTY));
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    item = utils::Trim(item);
+    if (item.empty()) {
+      continue;
+    }
+    if (std::find(tables.begin(), tables.end(), item) != tables.end()) {
+      throw utils::Exception("Duplicate table in " + TABLES_PROPERTY + ": " + item);
+    }
+    tables.push_back(item);
+  }
+  if (tables.empty()) {
+    tables.push_back(p.GetProperty(TABLENAME_PROPERTY, TABLENAME_DEFAULT));
+  }
+  return tables;
+}
+
+utils::Properties CoreWorkload::GetTableProperties(const utils::Properties &p, const std::string &table) {
+  utils::Properties table_props = p.Overlay(table + ".");
+  table_props.SetProperty(TABLENAME_PROPERTY, table);
+  // the table runs a single-table workload
+  table_props.SetProperty(TABLES_PROPERTY, "");
+  return table_props;
+}
+
+CoreWorkload *CreateWorkload(const utils::Properties &p, Measurements *measurements) {
+  std::string name = p.GetProperty(CoreWorkload::WORKLOAD_PROPERTY, CoreWorkload::WORKLOAD_DEFAULT);
+
+  CoreWorkload *workload;
+  if (!p.GetProperty(CoreWorkload::TABLES_PROPERTY).empty()) {
+    workload = new MultiTableWorkload();
+  } else if (name == CoreWorkload::WORKLOAD_DEFAULT || name == "core") {
+    workload = new CoreWorkload();
+  } else if (name == "queue") {
+    workload = new QueueWorkload();
+  } else if (name == "timeseries") {
+    workload = new TimeSeriesWorkload();
+  } else if (name == "graph") {
+    workload = new GraphWorkload();
+  } else if (name == "closedeconomy") {
+    workload = new ClosedEconomyWorkload();
+  } else {
+    return nullptr;
+  }
+
+  workload->SetMeasurements(measurements);
+  return workload;
+}
+
 } // ycsbc
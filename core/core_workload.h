@@ -10,6 +10,9 @@
 #ifndef YCSB_C_CORE_WORKLOAD_H_
 #define YCSB_C_CORE_WORKLOAD_H_
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <string>
 #include "db.h"
@@ -17,6 +20,7 @@
 #include "discrete_generator.h"
 #include "counter_generator.h"
 #include "acknowledged_counter_generator.h"
+#include "live_key_set.h"
 #include "utils/properties.h"
 #include "utils/utils.h"
 
@@ -29,25 +33,60 @@ enum Operation {
   SCAN,
   READMODIFYWRITE,
   DELETE,
+  BATCH_WRITE,
   INSERT_FAILED,
   READ_FAILED,
   UPDATE_FAILED,
   SCAN_FAILED,
   READMODIFYWRITE_FAILED,
   DELETE_FAILED,
+  BATCH_WRITE_FAILED,
+  // workload-level operations, each spanning one or more DB calls
+  ENQUEUE,
+  DEQUEUE,
+  MESSAGE_AGE,
+  APPEND_POINTS,
+  QUERY_WINDOW,
+  GET_NODE,
+  ADD_LINK,
+  DELETE_LINK,
+  COUNT_LINKS,
+  GET_LINK_RANGE,
+  TRANSACTION,
+  TRANSACTION_ABORTED,
+  VERIFY,
   MAXOPTYPE
 };
 
 extern const char *kOperationString[MAXOPTYPE];
 
+class Measurements;
+
 class CoreWorkload {
  public:
+  ///
+  /// The name of the property for the workload class.
+  /// Options are "core" (or the Java class name used by YCSB workload files),
+  /// "queue", "timeseries", "graph" and "closedeconomy". With "tables" set,
+  /// it names the workload of each table.
+  ///
+  static const std::string WORKLOAD_PROPERTY;
+  static const std::string WORKLOAD_DEFAULT;
+
   ///
   /// The name of the database table to run queries against.
   ///
   static const std::string TABLENAME_PROPERTY;
   static const std::string TABLENAME_DEFAULT;
 
+  ///
+  /// The name of the property for the tables of a multi-table run, a comma
+  /// separated list of table names. Each table runs a workload of its own,
+  /// and a property prefixed by the table name and a dot (e.g.
+  /// "orders.recordcount") applies to that table only.
+  ///
+  static const std::string TABLES_PROPERTY;
+
   ///
   /// The name of the property for the number of fields in a record.
   ///
@@ -112,13 +151,75 @@ class CoreWorkload {
   static const std::string READMODIFYWRITE_PROPORTION_PROPERTY;
   static const std::string READMODIFYWRITE_PROPORTION_DEFAULT;
 
+  ///
+  /// The name of the property for the proportion of delete transactions.
+  ///
+  static const std::string DELETE_PROPORTION_PROPERTY;
+  static const std::string DELETE_PROPORTION_DEFAULT;
+
+  ///
+  /// The name of the property for the proportion of reads, updates, scans and
+  /// read-modify-writes that deliberately target deleted keys. Only used
+  /// when deletes are enabled; other requests target live keys only.
+  ///
+  static const std::string DELETED_ACCESS_PROPORTION_PROPERTY;
+  static const std::string DELETED_ACCESS_PROPORTION_DEFAULT;
+
+  ///
+  /// The name of the property for detecting lost updates. Read-modify-writes
+  /// then increment a counter kept in the first field of the record, and the
+  /// end of the run compares the counters of the loaded records with the
+  /// increments the clients made. Needs a fresh load and a workload without
+  /// updates or deletes, which would overwrite the counters.
+  ///
+  static const std::string LOST_UPDATE_CHECK_PROPERTY;
+  static const std::string LOST_UPDATE_CHECK_DEFAULT;
+
+  ///
+  /// The name of the property for deterministic values. Each write then
+  /// stores "<version>:" followed by bytes derived from the key number, the
+  /// field name and the version, so that the verify phase can check every
+  /// field without remembering what was written. Needs a constant field
+  /// length that fits the version.
+  ///
+  static const std::string DATA_INTEGRITY_PROPERTY;
+  static const std::string DATA_INTEGRITY_DEFAULT;
+
   ///
   /// The name of the property for the the distribution of request keys.
-  /// Options are "uniform", "zipfian" and "latest".
+  /// Options are "uniform", "zipfian", "latest", "hotspot", "exponential",
+  /// "sequential" and "movinghotspot".
   ///
   static const std::string REQUEST_DISTRIBUTION_PROPERTY;
   static const std::string REQUEST_DISTRIBUTION_DEFAULT;
 
+  ///
+  /// The names of the properties for the hotspot distributions: the
+  /// fraction of records in the hot set and the fraction of requests that
+  /// go to it.
+  ///
+  static const std::string HOTSPOT_DATA_FRACTION_PROPERTY;
+  static const std::string HOTSPOT_DATA_FRACTION_DEFAULT;
+  static const std::string HOTSPOT_OPN_FRACTION_PROPERTY;
+  static const std::string HOTSPOT_OPN_FRACTION_DEFAULT;
+
+  ///
+  /// The name of the property for how fast the hot set of "movinghotspot"
+  /// slides through the records, in records per second.
+  ///
+  static const std::string MOVING_HOTSPOT_SPEED_PROPERTY;
+  static const std::string MOVING_HOTSPOT_SPEED_DEFAULT;
+
+  ///
+  /// The names of the properties for the "exponential" distribution:
+  /// percentile percent of the requests go to the most recent frac of the
+  /// records.
+  ///
+  static const std::string EXPONENTIAL_PERCENTILE_PROPERTY;
+  static const std::string EXPONENTIAL_PERCENTILE_DEFAULT;
+  static const std::string EXPONENTIAL_FRAC_PROPERTY;
+  static const std::string EXPONENTIAL_FRAC_DEFAULT;
+
   ///
   /// The default zero padding value. Matches integer sort order
   ///
@@ -154,6 +255,13 @@ class CoreWorkload {
   static const std::string INSERT_START_PROPERTY;
   static const std::string INSERT_START_DEFAULT;
 
+  ///
+  /// The name of the property for the prefix of every key, so that workloads
+  /// sharing a table can keep to key ranges of their own.
+  ///
+  static const std::string KEY_PREFIX_PROPERTY;
+  static const std::string KEY_PREFIX_DEFAULT;
+
   static const std::string RECORD_COUNT_PROPERTY;
   static const std::string OPERATION_COUNT_PROPERTY;
 
@@ -174,17 +282,121 @@ class CoreWorkload {
   ///
   virtual void Init(const utils::Properties &p);
 
+  ///
+  /// Sets where workload-level operations are reported.
+  ///
+  void SetMeasurements(Measurements *measurements) { measurements_ = measurements; }
+
   virtual bool DoInsert(DB &db);
   virtual bool DoTransaction(DB &db);
 
+  ///
+  /// Called once after each transaction phase, when the clients have
+  /// stopped, for end-of-run reports and consistency checks.
+  ///
+  virtual void FinishRun(DB &db);
+
+  ///
+  /// Reads and checks the next record of the verify phase. Returns false if
+  /// it is missing or its fields are not what dataintegrity writes.
+  ///
+  virtual bool DoVerify(DB &db);
+
+  ///
+  /// Reads record key_num and checks it as the verify phase does. Returns
+  /// kOK if it is intact, kNotFound if it is missing and kError otherwise.
+  ///
+  DB::Status VerifyRecord(DB &db, uint64_t key_num);
+
+  ///
+  /// Sets acks[key_num] to 1 once the database has acknowledged the load or
+  /// run insert of record key_num, and back to 0 when the run deletes it,
+  /// for key numbers below size. The array may be shared with another
+  /// process.
+  ///
+  void SetInsertAcks(std::atomic<uint8_t> *acks, uint64_t size) {
+    insert_acks_ = acks;
+    insert_acks_size_ = size;
+  }
+
+  ///
+  /// Called once after the verify phase. Prints what was found and returns
+  /// false if any record failed.
+  ///
+  virtual bool FinishVerify();
+
+  ///
+  /// Number of records the verify phase checks.
+  ///
+  virtual uint64_t GetVerifyRecordCount() { return GetRecordCount() - insert_start_; }
+
+  ///
+  /// Number of records the load phase inserts.
+  ///
+  virtual uint64_t GetLoadRecordCount() { return record_count_; }
+
+  ///
+  /// First key number of the load phase, which inserts GetLoadRecordCount()
+  /// records from there.
+  ///
+  uint64_t GetLoadStart() { return insert_start_; }
+
+  ///
+  /// Key and values of load record key_num as DoInsert builds them, for
+  /// generating the load dataset offline.
+  ///
+  std::string BuildLoadKey(uint64_t key_num) { return BuildKeyName(key_num); }
+  void BuildLoadValues(uint64_t key_num, std::vector<DB::Field> &values) { BuildValues(key_num, values); }
+
+  ///
+  /// Adds to state the properties a later invocation needs to continue from
+  /// the data this one left, e.g. the record count grown by inserts.
+  ///
+  virtual void SaveState(utils::Properties &state);
+
+  ///
+  /// Names of the tables of the run: the "tables" list, or the table named
+  /// by "table" if there is no list.
+  ///
+  static std::vector<std::string> GetTableNames(const utils::Properties &p);
+
+  ///
+  /// Properties of one table of a multi-table run, with the properties
+  /// prefixed by its name applied.
+  ///
+  static utils::Properties GetTableProperties(const utils::Properties &p, const std::string &table);
+
   bool read_all_fields() const { return read_all_fields_; }
   bool write_all_fields() const { return write_all_fields_; }
 
+  ///
+  /// Number of records including those inserted so far, so that a following
+  /// phase can continue from where this one stopped.
+  ///
+  uint64_t GetRecordCount() {
+    // Last() is one below the start value if nothing was inserted
+    return std::max(insert_key_sequence_->Last() + 1, transaction_insert_key_sequence_->Last() + 1);
+  }
+
+  ///
+  /// Number of records the database holds, for sizing the live data: those
+  /// from insertstart on, less the ones this process deleted.
+  ///
+  virtual uint64_t GetLiveRecordCount() {
+    const uint64_t records = GetRecordCount() - insert_start_;
+    const uint64_t deleted = deleted_records_.load();
+    return deleted < records ? records - deleted : 0;
+  }
+
   CoreWorkload() :
       field_count_(0), read_all_fields_(false), write_all_fields_(false),
       field_len_generator_(nullptr), key_chooser_(nullptr), field_chooser_(nullptr),
       scan_len_chooser_(nullptr), insert_key_sequence_(nullptr),
-      transaction_insert_key_sequence_(nullptr), ordered_inserts_(true), record_count_(0) {
+      transaction_insert_key_sequence_(nullptr), live_keys_(nullptr), deleted_records_(0), deleted_access_proportion_(0),
+      lost_update_check_(false), data_integrity_(false), field_length_(0), write_version_(0),
+      verify_sequence_(0), verify_ok_(0), verify_deleted_(0), verify_missing_(0), verify_corrupt_(0),
+      insert_acks_(nullptr), insert_acks_size_(0),
+      ordered_inserts_(true), record_count_(0), insert_start_(0), measurements_(nullptr) {
   }
 
   virtual ~CoreWorkload() {
@@ -194,6 +406,7 @@ class CoreWorkload {
     delete scan_len_chooser_;
     delete insert_key_sequence_;
     delete transaction_insert_key_sequence_;
+    delete live_keys_;
   }
 
  protected:
@@ -201,8 +414,17 @@ class CoreWorkload {
   std::string BuildKeyName(uint64_t key_num);
   void BuildValues(std::vector<DB::Field> &values);
   void BuildSingleValue(std::vector<DB::Field> &update);
+  // values of record key_num, deterministic with dataintegrity
+  void BuildValues(uint64_t key_num, std::vector<DB::Field> &values);
+  void BuildSingleValue(uint64_t key_num, std::vector<DB::Field> &update);
+  std::string BuildDeterministicValue(uint64_t key_num, const std::string &field, uint64_t version);
+  bool VerifyValue(uint64_t key_num, const DB::Field &field);
+  // first key number inserted by the transaction phase
+  virtual uint64_t TransactionInsertStart(const utils::Properties &p) { return record_count_; }
 
   uint64_t NextTransactionKeyNum();
+  uint64_t NextTransactionKeyNum(bool live);
+  uint64_t NextAccessKeyNum();
   std::string NextFieldName();
 
   DB::Status TransactionRead(DB &db);
@@ -210,6 +432,8 @@ class CoreWorkload {
   DB::Status TransactionScan(DB &db);
   DB::Status TransactionUpdate(DB &db);
   DB::Status TransactionInsert(DB &db);
+  DB::Status TransactionDelete(DB &db);
+  DB::Status CountedReadModifyWrite(DB &db, uint64_t key_num);
 
   std::string table_name_;
   int field_count_;
@@ -223,11 +447,35 @@ class CoreWorkload {
   Generator<uint64_t> *scan_len_chooser_;
   CounterGenerator *insert_key_sequence_; // load insert key gen
   AcknowledgedCounterGenerator *transaction_insert_key_sequence_; // transaction insert key gen
+  LiveKeySet *live_keys_; // only tracked when deletes are enabled
+  std::atomic<uint64_t> deleted_records_;
+  double deleted_access_proportion_;
+  bool lost_update_check_;
+  std::unique_ptr<std::atomic<uint32_t>[]> rmw_counts_; // increments per loaded record
+  bool data_integrity_;
+  size_t field_length_;
+  std::atomic<uint64_t> write_version_;
+  std::atomic<uint64_t> verify_sequence_;
+  std::atomic<uint64_t> verify_ok_;
+  std::atomic<uint64_t> verify_deleted_;
+  std::atomic<uint64_t> verify_missing_;
+  std::atomic<uint64_t> verify_corrupt_;
+  std::atomic<uint8_t> *insert_acks_;
+  uint64_t insert_acks_size_;
   bool ordered_inserts_;
   size_t record_count_;
+  uint64_t insert_start_;
   int zero_padding_;
+  std::string key_prefix_;
+  Measurements *measurements_;
 };
 
+///
+/// Creates the workload named by the "workload" property, or nullptr if the
+/// name is unknown.
+///
+CoreWorkload *CreateWorkload(const utils::Properties &p, Measurements *measurements);
+
 } // ycsbc
 
 #endif // YCSB_C_CORE_WORKLOAD_H_
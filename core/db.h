@@ -11,6 +11,8 @@
 
 #include "utils/properties.h"
 
+#include <algorithm>
+#include <functional>
 #include <vector>
 #include <string>
 
@@ -30,9 +32,55 @@ class DB {
     kOK = 0,
     kError,
     kNotFound,
-    kNotImplemented
+    kNotImplemented,
+    kAborted
   };
   ///
+  /// One write of a batch: an insert, which replaces any existing record,
+  /// or a delete.
+  ///
+  struct Mutation {
+    enum Type { kInsert, kDelete };
+    Type type;
+    std::string key;
+    std::vector<Field> values;
+  };
+  ///
+  /// A multi-record transaction on one table, from BeginTransaction. Reads
+  /// see a consistent state and writes become visible together at Commit.
+  /// A call that conflicts with a concurrent transaction returns kAborted;
+  /// the caller then calls Rollback and may retry. Finish with Commit or
+  /// Rollback, then delete the transaction.
+  ///
+  class Transaction {
+   public:
+    ///
+    /// Reads a record, locking it or recording it for conflict detection.
+    ///
+    virtual Status Read(const std::string &key, const std::vector<std::string> *fields,
+                        std::vector<Field> &result) = 0;
+    ///
+    /// Writes a whole record, replacing any existing one.
+    ///
+    virtual Status Write(const std::string &key, std::vector<Field> &values) = 0;
+    ///
+    /// Commits the transaction. Returns kAborted if it conflicted, in which
+    /// case none of its writes took effect.
+    ///
+    virtual Status Commit() = 0;
+    ///
+    /// Discards the writes of the transaction.
+    ///
+    virtual void Rollback() = 0;
+
+    virtual ~Transaction() { }
+  };
+  ///
+  /// Computes the field/value pairs to write from the fields read, for
+  /// ReadModifyWrite.
+  ///
+  typedef std::function<void(const std::vector<Field> &result, std::vector<Field> &values)> Modifier;
+  ///
   /// Initializes any state for accessing this DB.
   ///
   virtual void Init() { }
@@ -69,6 +117,23 @@ class DB {
                    int record_count, const std::vector<std::string> *fields,
                    std::vector<std::vector<Field>> &result) = 0;
   ///
+  /// Called by ScanAll for each record with the number of bytes read for
+  /// its key and value. Returning false ends the scan.
+  ///
+  typedef std::function<bool(size_t bytes)> ScanVisitor;
+  ///
+  /// Reads every record of a table in key order, as an analytical query
+  /// would, with one iterator, cursor or read transaction held open for the
+  /// whole scan. Records are not kept, so the table may be of any size.
+  ///
+  /// @param table The name of the table.
+  /// @param visit Called for each record.
+  /// @return Zero on success, kNotImplemented if the database has no such scan.
+  ///
+  virtual Status ScanAll(const std::string &table, const ScanVisitor &visit) {
+    return kNotImplemented;
+  }
+  ///
   /// Updates a record in the database.
   /// Field/value pairs in the specified vector are written to the record,
   /// overwriting any existing values with the same field names.
@@ -99,6 +164,123 @@ class DB {
   /// @return Zero on success, a non-zero error code on error.
   ///
   virtual Status Delete(const std::string &table, const std::string &key) = 0;
+  ///
+  /// Applies a batch of inserts and deletes, in one atomic write where the
+  /// database supports it. The default applies them one by one and stops at
+  /// the first failure.
+  ///
+  /// @param table The name of the table.
+  /// @param batch The writes to apply, in order.
+  /// @return Zero on success, a non-zero error code on error.
+  ///
+  virtual Status BatchWrite(const std::string &table, std::vector<Mutation> &batch) {
+    for (Mutation &m : batch) {
+      Status s = (m.type == Mutation::kInsert) ? Insert(table, m.key, m.values) : Delete(table, m.key);
+      if (s != kOK) {
+        return s;
+      }
+    }
+    return kOK;
+  }
+
+  ///
+  /// Reads a record, computes new values from it and updates the record.
+  /// The default runs in a transaction if the database supports them, and
+  /// retries it when it conflicts. Without transactions it is a read then an
+  /// update, and a concurrent write in between is lost.
+  ///
+  /// @param table The name of the table.
+  /// @param key The key of the record.
+  /// @param fields The list of fields to read, or NULL for all of them.
+  /// @param result A vector of field/value pairs for the result.
+  /// @param modify Fills in the field/value pairs to write. It runs again
+  ///        with a fresh result if the transaction is retried.
+  /// @return Zero on success, a non-zero error code on error/record-miss.
+  ///
+  virtual Status ReadModifyWrite(const std::string &table, const std::string &key,
+                                 const std::vector<std::string> *fields,
+                                 std::vector<Field> &result, const Modifier &modify) {
+    const int kMaxAttempts = 100;
+    for (int i = 0; i < kMaxAttempts; i++) {
+      Transaction *txn = BeginTransaction(table);
+      if (txn == nullptr) {
+        Status s = Read(table, key, fields, result);
+        if (s != kOK) {
+          return s;
+        }
+        std::vector<Field> values;
+        modify(result, values);
+        return Update(table, key, values);
+      }
+      result.clear();
+      Status s = ReadModifyWriteInTransaction(*txn, key, fields, result, modify);
+      delete txn;
+      if (s != kAborted) {
+        return s;
+      }
+    }
+    return kAborted;
+  }
+  ///
+  /// Starts a transaction on this thread's handle.
+  ///
+  /// @param table The name of the table.
+  /// @return The new transaction, or nullptr if the database has no
+  ///         transaction support or it is disabled.
+  ///
+  virtual Transaction *BeginTransaction(const std::string &table) {
+    return nullptr;
+  }
+
+  ///
+  /// Writes a consistent copy of the whole database into a new directory,
+  /// with the database's own checkpoint or backup facility.
+  ///
+  /// @param dir The directory to create.
+  /// @return Zero on success, kNotImplemented if the database cannot do it.
+  ///
+  virtual Status Checkpoint(const std::string &dir) {
+    return kNotImplemented;
+  }
+  ///
+  /// Replaces the database with a copy made by Checkpoint. Called on a
+  /// handle that is not initialized, while no handle has the database open.
+  ///
+  /// @param dir The directory written by Checkpoint.
+  /// @return Zero on success, kNotImplemented if the database cannot do it.
+  ///
+  virtual Status Restore(const std::string &dir) {
+    return kNotImplemented;
+  }
+  ///
+  /// Loads records generated offline into an empty table through the
+  /// database's own bulk path, e.g. building its files directly, instead of
+  /// one insert per record. Called on one handle while no other is in use.
+  ///
+  /// @param table The name of the table.
+  /// @param files Files written by BulkFileWriter, each sorted by key and
+  ///        with keys above those of the files before it.
+  /// @return Zero on success, kNotImplemented if the database has no bulk path.
+  ///
+  virtual Status BulkLoad(const std::string &table, const std::vector<std::string> &files) {
+    return kNotImplemented;
+  }
+  ///
+  /// Files and directories that hold the database on disk, e.g. to evict
+  /// them from the page cache. Empty if it keeps nothing on disk.
+  ///
+  virtual std::vector<std::string> GetDataPaths() {
+    return {};
+  }
+  ///
+  /// Appends engine-internal counters and gauges to stats, each as a name
+  /// without spaces and its value. May be called from another thread while
+  /// the handle is in use, and while the database is not open, in which case
+  /// it returns kError.
+  ///
+  virtual Status GetStats(std::vector<Field> &stats) {
+    return kNotImplemented;
+  }
 
   virtual ~DB() { }
 
@@ -106,6 +288,43 @@ class DB {
     props_ = props;
   }
  protected:
+  ///
+  /// One attempt of ReadModifyWrite in a transaction, which it finishes.
+  ///
+  static Status ReadModifyWriteInTransaction(Transaction &txn, const std::string &key,
+                                             const std::vector<std::string> *fields,
+                                             std::vector<Field> &result, const Modifier &modify) {
+    // transactions write whole records, so read all fields and merge
+    std::vector<Field> record;
+    Status s = txn.Read(key, NULL, record);
+    if (s != kOK) {
+      txn.Rollback();
+      return s;
+    }
+    for (Field &field : record) {
+      if (fields == nullptr || std::find(fields->begin(), fields->end(), field.name) != fields->end()) {
+        result.push_back(field);
+      }
+    }
+    std::vector<Field> values;
+    modify(result, values);
+    for (Field &value : values) {
+      auto it = std::find_if(record.begin(), record.end(),
+                             [&value](const Field &field) { return field.name == value.name; });
+      if (it != record.end()) {
+        it->value = value.value;
+      } else {
+        record.push_back(value);
+      }
+    }
+    s = txn.Write(key, record);
+    if (s != kOK) {
+      txn.Rollback();
+      return s;
+    }
+    return txn.Commit();
+  }
+
   utils::Properties *props_;
 };
 
@@ -8,10 +8,12 @@
 #ifndef YCSB_C_DB_WRAPPER_H_
 #define YCSB_C_DB_WRAPPER_H_
 
+#include <atomic>
 #include <string>
 #include <vector>
 
 #include "db.h"
+#include "event_timeline.h"
 #include "measurements.h"
 #include "utils/timer.h"
 #include "utils/utils.h"
@@ -35,10 +37,13 @@ class DBWrapper : public DB {
     timer_.Start();
     Status s = db_->Read(table, key, fields, result);
     uint64_t elapsed = timer_.End();
+    if (elapsed >= EventTimeline::SlowOpThreshold()) {
+      EventTimeline::SlowOp(READ, table, key, elapsed);
+    }
     if (s == kOK) {
-      measurements_->Report(READ, elapsed);
+      measurements_->ReportTable(table, READ, elapsed);
     } else {
-      measurements_->Report(READ_FAILED, elapsed);
+      measurements_->ReportTable(table, READ_FAILED, elapsed);
     }
     return s;
   }
@@ -47,21 +52,32 @@ class DBWrapper : public DB {
     timer_.Start();
     Status s = db_->Scan(table, key, record_count, fields, result);
     uint64_t elapsed = timer_.End();
+    if (elapsed >= EventTimeline::SlowOpThreshold()) {
+      EventTimeline::SlowOp(SCAN, table, key, elapsed);
+    }
     if (s == kOK) {
-      measurements_->Report(SCAN, elapsed);
+      measurements_->ReportTable(table, SCAN, elapsed);
     } else {
-      measurements_->Report(SCAN_FAILED, elapsed);
+      measurements_->ReportTable(table, SCAN_FAILED, elapsed);
     }
     return s;
   }
+  Status ScanAll(const std::string &table, const ScanVisitor &visit) {
+    // measured by the caller, in bytes rather than per operation
+    return db_->ScanAll(table, visit);
+  }
   Status Update(const std::string &table, const std::string &key, std::vector<Field> &values) {
     timer_.Start();
     Status s = db_->Update(table, key, values);
     uint64_t elapsed = timer_.End();
+    if (elapsed >= EventTimeline::SlowOpThreshold()) {
+      EventTimeline::SlowOp(UPDATE, table, key, elapsed);
+    }
     if (s == kOK) {
-      measurements_->Report(UPDATE, elapsed);
+      measurements_->ReportTable(table, UPDATE, elapsed);
+      bytes_written_.fetch_add(LogicalSize(key, values), std::memory_order_relaxed);
     } else {
-      measurements_->Report(UPDATE_FAILED, elapsed);
+      measurements_->ReportTable(table, UPDATE_FAILED, elapsed);
     }
     return s;
   }
@@ -69,10 +85,14 @@ class DBWrapper : public DB {
     timer_.Start();
     Status s = db_->Insert(table, key, values);
     uint64_t elapsed = timer_.End();
+    if (elapsed >= EventTimeline::SlowOpThreshold()) {
+      EventTimeline::SlowOp(INSERT, table, key, elapsed);
+    }
     if (s == kOK) {
-      measurements_->Report(INSERT, elapsed);
+      measurements_->ReportTable(table, INSERT, elapsed);
+      CountInsert(LogicalSize(key, values), 1);
     } else {
-      measurements_->Report(INSERT_FAILED, elapsed);
+      measurements_->ReportTable(table, INSERT_FAILED, elapsed);
     }
     return s;
   }
@@ -80,14 +100,123 @@ class DBWrapper : public DB {
     timer_.Start();
     Status s = db_->Delete(table, key);
     uint64_t elapsed = timer_.End();
+    if (elapsed >= EventTimeline::SlowOpThreshold()) {
+      EventTimeline::SlowOp(DELETE, table, key, elapsed);
+    }
+    if (s == kOK) {
+      measurements_->ReportTable(table, DELETE, elapsed);
+      bytes_written_.fetch_add(key.size(), std::memory_order_relaxed);
+    } else {
+      measurements_->ReportTable(table, DELETE_FAILED, elapsed);
+    }
+    return s;
+  }
+  Status BatchWrite(const std::string &table, std::vector<Mutation> &batch) {
+    timer_.Start();
+    Status s = db_->BatchWrite(table, batch);
+    uint64_t elapsed = timer_.End();
+    if (elapsed >= EventTimeline::SlowOpThreshold() && !batch.empty()) {
+      EventTimeline::SlowOp(BATCH_WRITE, table, batch.front().key, elapsed);
+    }
     if (s == kOK) {
-      measurements_->Report(DELETE, elapsed);
+      measurements_->ReportTable(table, BATCH_WRITE, elapsed);
+      uint64_t insert_bytes = 0;
+      uint64_t inserts = 0;
+      for (const Mutation &m : batch) {
+        if (m.type == Mutation::kInsert) {
+          insert_bytes += LogicalSize(m.key, m.values);
+          inserts++;
+        } else {
+          bytes_written_.fetch_add(m.key.size(), std::memory_order_relaxed);
+        }
+      }
+      CountInsert(insert_bytes, inserts);
     } else {
-      measurements_->Report(DELETE_FAILED, elapsed);
+      measurements_->ReportTable(table, BATCH_WRITE_FAILED, elapsed);
     }
     return s;
   }
+  Status ReadModifyWrite(const std::string &table, const std::string &key,
+                         const std::vector<std::string> *fields, std::vector<Field> &result,
+                         const Modifier &modify) {
+    // the fields written are those of the last call to modify
+    uint64_t written = 0;
+    const Modifier counted = [&modify, &key, &written](const std::vector<Field> &read, std::vector<Field> &values) {
+      modify(read, values);
+      written = LogicalSize(key, values);
+    };
+    timer_.Start();
+    Status s = db_->ReadModifyWrite(table, key, fields, result, counted);
+    uint64_t elapsed = timer_.End();
+    if (elapsed >= EventTimeline::SlowOpThreshold()) {
+      EventTimeline::SlowOp(READMODIFYWRITE, table, key, elapsed);
+    }
+    if (s == kOK) {
+      measurements_->ReportTable(table, READMODIFYWRITE, elapsed);
+      bytes_written_.fetch_add(written, std::memory_order_relaxed);
+    } else {
+      measurements_->ReportTable(table, READMODIFYWRITE_FAILED, elapsed);
+    }
+    return s;
+  }
+  Transaction *BeginTransaction(const std::string &table) {
+    return db_->BeginTransaction(table);
+  }
+  Status Checkpoint(const std::string &dir) {
+    return db_->Checkpoint(dir);
+  }
+  Status Restore(const std::string &dir) {
+    return db_->Restore(dir);
+  }
+  Status BulkLoad(const std::string &table, const std::vector<std::string> &files) {
+    // timed by the caller as a whole
+    return db_->BulkLoad(table, files);
+  }
+  std::vector<std::string> GetDataPaths() {
+    return db_->GetDataPaths();
+  }
+  Status GetStats(std::vector<Field> &stats) {
+    return db_->GetStats(stats);
+  }
+
+  ///
+  /// The wrapped handle, for reads that should not count as operations,
+  /// e.g. the checks after a run.
+  ///
+  DB *unmeasured() { return db_; }
+
+  ///
+  /// Logical bytes written through all wrappers: the keys, field names and
+  /// values of inserts, updates, read-modify-writes and batches, and the keys
+  /// of deletes. Writes inside a Transaction are not counted.
+  ///
+  static uint64_t BytesWritten() { return bytes_written_.load(std::memory_order_relaxed); }
+  ///
+  /// Records inserted through all wrappers and their logical bytes.
+  ///
+  static uint64_t RecordsInserted() { return records_inserted_.load(std::memory_order_relaxed); }
+  static uint64_t BytesInserted() { return bytes_inserted_.load(std::memory_order_relaxed); }
+  ///
+  /// Counts inserts the wrappers do not see, e.g. those of a bulk load.
+  ///
+  static void CountInsert(uint64_t bytes, uint64_t records) {
+    bytes_written_.fetch_add(bytes, std::memory_order_relaxed);
+    bytes_inserted_.fetch_add(bytes, std::memory_order_relaxed);
+    records_inserted_.fetch_add(records, std::memory_order_relaxed);
+  }
  private:
+  static uint64_t LogicalSize(const std::string &key, const std::vector<Field> &values) {
+    uint64_t bytes = key.size();
+    for (const Field &field : values) {
+      bytes += field.name.size() + field.value.size();
+    }
+    return bytes;
+  }
+
+  static inline std::atomic<uint64_t> bytes_written_{0};
+  static inline std::atomic<uint64_t> bytes_inserted_{0};
+  static inline std::atomic<uint64_t> records_inserted_{0};
+
   DB *db_;
   Measurements *measurements_;
   utils::Timer<uint64_t, std::nano> timer_;
@@ -0,0 +1,239 @@
+//
+//  event_timeline.cc
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#include "event_timeline.h"
+#include "utils/affinity.h"
+#include "utils/utils.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+namespace ycsbc {
+
+const std::string EventTimeline::FILE_PROPERTY = "timeline.file";
+
+const std::string EventTimeline::INTERVAL_PROPERTY = "timeline.interval";
+const std::string EventTimeline::INTERVAL_DEFAULT = "1";
+
+const std::string EventTimeline::SLOW_OP_PROPERTY = "timeline.slowop";
+const std::string EventTimeline::SLOW_OP_DEFAULT = "0";
+
+const std::string EventTimeline::MAX_SLOW_OPS_PROPERTY = "timeline.maxslowops";
+const std::string EventTimeline::MAX_SLOW_OPS_DEFAULT = "100000";
+
+bool EventTimeline::enabled_ = false;
+std::string EventTimeline::file_;
+int EventTimeline::interval_ = 1;
+uint64_t EventTimeline::slow_op_ns_ = std::numeric_limits<uint64_t>::max();
+uint64_t EventTimeline::max_slow_ops_ = 0;
+
+namespace {
+
+// the clock of utils::Timer, which times the operations
+using Clock = std::chrono::high_resolution_clock;
+
+Clock::time_point epoch;
+std::mutex events_mu;
+std::vector<std::string> events;
+std::atomic<uint64_t> slow_ops(0);
+std::atomic<uint64_t> next_client(0);
+
+// percentiles of each interval, as far as the measurements keep them
+const std::pair<double, const char *> kPercentiles[] = {
+  {50, "p50"}, {99, "p99"}, {99.9, "p99.9"}, {100, "max"},
+};
+
+} // namespace
+
+void EventTimeline::Init(const utils::Properties &p) {
+  file_ = p.GetProperty(FILE_PROPERTY, "");
+  enabled_ = !file_.empty();
+  interval_ = std::stoi(p.GetProperty(INTERVAL_PROPERTY, INTERVAL_DEFAULT));
+  const uint64_t slow_op_us = std::stoull(p.GetProperty(SLOW_OP_PROPERTY, SLOW_OP_DEFAULT));
+  max_slow_ops_ = std::stoull(p.GetProperty(MAX_SLOW_OPS_PROPERTY, MAX_SLOW_OPS_DEFAULT));
+  if (interval_ <= 0) {
+    throw utils::Exception("Invalid timeline parameters");
+  }
+  slow_op_ns_ = (enabled_ && slow_op_us > 0) ? slow_op_us * 1000 : std::numeric_limits<uint64_t>::max();
+  epoch = Clock::now();
+}
+
+uint64_t EventTimeline::Now() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - epoch).count();
+}
+
+std::string EventTimeline::Quote(const std::string &s) {
+  std::string quoted = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+      quoted += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      quoted += escaped;
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
+std::string EventTimeline::Args(const std::vector<std::pair<std::string, std::string>> &args) {
+  std::string json = "{";
+  for (const auto &arg : args) {
+    if (json.size() > 1) {
+      json += ',';
+    }
+    json += Quote(arg.first) + ':' + Quote(arg.second);
+  }
+  return json + "}";
+}
+
+void EventTimeline::Add(std::string event) {
+  std::lock_guard<std::mutex> lock(events_mu);
+  events.push_back(std::move(event));
+}
+
+void EventTimeline::Complete(const std::string &name, const std::string &category, Process pid, uint64_t tid,
+                             uint64_t ts, uint64_t dur, const std::string &args) {
+  if (!enabled_) {
+    return;
+  }
+  std::string event = "{\"ph\":\"X\",\"name\":" + Quote(name) + ",\"cat\":" + Quote(category) +
+                      ",\"pid\":" + std::to_string(pid) + ",\"tid\":" + std::to_string(tid) +
+                      ",\"ts\":" + std::to_string(ts) + ",\"dur\":" + std::to_string(dur);
+  if (!args.empty()) {
+    event += ",\"args\":" + args;
+  }
+  Add(event + "}");
+}
+
+void EventTimeline::Counter(const std::string &name, uint64_t ts,
+                            const std::vector<std::pair<std::string, double>> &values) {
+  if (!enabled_ || values.empty()) {
+    return;
+  }
+  std::string event = "{\"ph\":\"C\",\"name\":" + Quote(name) + ",\"pid\":" + std::to_string(kClients) +
+                      ",\"ts\":" + std::to_string(ts) + ",\"args\":{";
+  for (size_t i = 0; i < values.size(); i++) {
+    event += (i > 0 ? "," : "") + Quote(values[i].first) + ':' + std::to_string(values[i].second);
+  }
+  Add(event + "}}");
+}
+
+void EventTimeline::SlowOp(Operation op, const std::string &table, const std::string &key,
+                           uint64_t latency_ns) {
+  if (slow_ops.fetch_add(1, std::memory_order_relaxed) >= max_slow_ops_) {
+    return;
+  }
+  // one lane per client thread
+  thread_local const uint64_t lane = next_client.fetch_add(1);
+  const uint64_t dur = latency_ns / 1000;
+  const uint64_t now = Now();
+  Complete(kOperationString[op], "slow op", kClients, lane, now > dur ? now - dur : 0, dur,
+           Args({{"table", table}, {"key", key}}));
+}
+
+size_t EventTimeline::Write() {
+  std::ofstream output(file_ + ".tmp");
+  output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+  output << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << kClients
+         << ",\"args\":{\"name\":\"clients\"}}," << std::endl;
+  output << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << kEngine
+         << ",\"args\":{\"name\":\"engine\"}}";
+  size_t count;
+  {
+    std::lock_guard<std::mutex> lock(events_mu);
+    for (const std::string &event : events) {
+      output << ',' << std::endl << event;
+    }
+    count = events.size();
+  }
+  output << std::endl << "]}" << std::endl;
+  output.close();
+  if (output.fail() || rename((file_ + ".tmp").c_str(), file_.c_str())) {
+    throw utils::Exception("failed to write: " + file_);
+  }
+  return count;
+}
+
+void EventTimeline::Start(Measurements *measurements, DB *db, std::vector<int> cpus) {
+  measurements_ = dynamic_cast<IntervalMeasurements *>(measurements);
+  if (!enabled_ || measurements_ == nullptr) {
+    return;
+  }
+  db_ = db;
+  stop_ = false;
+  current_ = measurements_->OpenInterval();
+  thread_ = std::thread(&EventTimeline::Sample, this, cpus);
+}
+
+void EventTimeline::Stop() {
+  if (!thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+  measurements_->CloseInterval(current_);
+  const size_t count = Write();
+  std::cout << "Timeline events: " << count << " in " << file_ << std::endl;
+}
+
+void EventTimeline::Sample(std::vector<int> cpus) {
+  utils::SetThreadAffinity(cpus);
+  const auto start = std::chrono::steady_clock::now();
+  for (int n = 1; ; n++) {
+    const auto deadline = start + std::chrono::seconds(static_cast<int64_t>(n) * interval_);
+    std::unique_lock<std::mutex> lock(mu_);
+    if (cv_.wait_until(lock, deadline, [this] { return stop_; })) {
+      return;
+    }
+    lock.unlock();
+
+    const uint64_t ts = Now();
+    const uint64_t ops = current_->GetClientOps();
+    for (int i = 0; i < MAXOPTYPE; i++) {
+      const Operation op = static_cast<Operation>(i);
+      if (current_->GetCount(op) == 0) {
+        continue;
+      }
+      std::vector<std::pair<std::string, double>> latency;
+      for (const auto &percentile : kPercentiles) {
+        try {
+          latency.emplace_back(percentile.second, current_->GetLatencyPercentile(op, percentile.first) / 1000.0);
+        } catch (const utils::Exception &) {
+          // basic measurements only keep the max
+        }
+      }
+      Counter(std::string(kOperationString[op]) + " latency(us)", ts, latency);
+    }
+    current_->Reset();
+    Counter("throughput(ops/sec)", ts, {{"ops/sec", static_cast<double>(ops) / interval_}});
+
+    std::vector<DB::Field> stats;
+    if (db_->GetStats(stats) == DB::kOK) {
+      for (const DB::Field &stat : stats) {
+        char *end;
+        const double value = strtod(stat.value.c_str(), &end);
+        if (end != stat.value.c_str()) {
+          Counter(stat.name, ts, {{"value", value}});
+        }
+      }
+    }
+  }
+}
+
+} // ycsbc
@@ -0,0 +1,151 @@
+//
+//  event_timeline.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_EVENT_TIMELINE_H_
+#define YCSB_C_EVENT_TIMELINE_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "db.h"
+#include "measurements.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// A timeline of the background work of the engine next to the latency the
+/// clients saw, written as Chrome trace JSON (chrome://tracing, Perfetto) so
+/// that a latency spike can be matched with the flush, compaction or write
+/// stall under it. It holds:
+///
+/// - engine events recorded by the bindings, e.g. from a RocksDB
+///   EventListener, as spans on the engine's background threads
+/// - latency percentiles and throughput of every timeline.interval seconds,
+///   and the DB::GetStats values sampled at the same time, as counters
+/// - operations slower than timeline.slowop microseconds, as spans on the
+///   client threads, up to timeline.maxslowops of them
+///
+/// Events are kept for the whole process and all share the clock of the
+/// measurements. The file is rewritten at the end of every phase.
+///
+class EventTimeline {
+ public:
+  ///
+  /// The name of the property for the trace file. No timeline is kept
+  /// without it.
+  ///
+  static const std::string FILE_PROPERTY;
+
+  ///
+  /// The name of the property for how often, in seconds, percentiles and
+  /// engine statistics are sampled.
+  ///
+  static const std::string INTERVAL_PROPERTY;
+  static const std::string INTERVAL_DEFAULT;
+
+  ///
+  /// The name of the property for the latency, in microseconds, from which
+  /// an operation is recorded. 0 records none.
+  ///
+  static const std::string SLOW_OP_PROPERTY;
+  static const std::string SLOW_OP_DEFAULT;
+
+  ///
+  /// The name of the property for the most slow operations recorded.
+  ///
+  static const std::string MAX_SLOW_OPS_PROPERTY;
+  static const std::string MAX_SLOW_OPS_DEFAULT;
+
+  ///
+  /// Processes the events are grouped under.
+  ///
+  enum Process { kClients = 1, kEngine = 2 };
+
+  ///
+  /// Sets up the timeline of the process. Must be called before the
+  /// database is opened, so that bindings see Enabled.
+  ///
+  static void Init(const utils::Properties &p);
+
+  static bool Enabled() { return enabled_; }
+
+  ///
+  /// Microseconds since Init, on the clock of the measurements.
+  ///
+  static uint64_t Now();
+
+  ///
+  /// Records a span of dur microseconds from ts on thread tid. args is a
+  /// JSON object, or empty.
+  ///
+  static void Complete(const std::string &name, const std::string &category, Process pid, uint64_t tid,
+                       uint64_t ts, uint64_t dur, const std::string &args);
+
+  ///
+  /// Records the values of a counter at ts.
+  ///
+  static void Counter(const std::string &name, uint64_t ts,
+                      const std::vector<std::pair<std::string, double>> &values);
+
+  ///
+  /// Latency in nanoseconds from which DBWrapper reports an operation with
+  /// SlowOp.
+  ///
+  static uint64_t SlowOpThreshold() { return slow_op_ns_; }
+
+  static void SlowOp(Operation op, const std::string &table, const std::string &key, uint64_t latency_ns);
+
+  ///
+  /// A JSON object of string values, e.g. for the args of Complete.
+  ///
+  static std::string Args(const std::vector<std::pair<std::string, std::string>> &args);
+
+  ///
+  /// Starts sampling measurements, which must be IntervalMeasurements as
+  /// CreateMeasurements makes them, and the statistics of db.
+  ///
+  void Start(Measurements *measurements, DB *db, std::vector<int> cpus);
+
+  ///
+  /// Stops sampling and writes the whole timeline to the file.
+  ///
+  void Stop();
+
+  EventTimeline() : measurements_(nullptr), current_(nullptr), db_(nullptr), stop_(false) {}
+
+ private:
+  static void Add(std::string event);
+  static std::string Quote(const std::string &s);
+  ///
+  /// Writes the events to the file. Returns how many there are.
+  ///
+  static size_t Write();
+  void Sample(std::vector<int> cpus);
+
+  static bool enabled_;
+  static std::string file_;
+  static int interval_;
+  static uint64_t slow_op_ns_;
+  static uint64_t max_slow_ops_;
+
+  IntervalMeasurements *measurements_;
+  Measurements *current_;
+  DB *db_;
+  std::thread thread_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool stop_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_EVENT_TIMELINE_H_
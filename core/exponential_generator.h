@@ -0,0 +1,56 @@
+//
+//  exponential_generator.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_EXPONENTIAL_GENERATOR_H_
+#define YCSB_C_EXPONENTIAL_GENERATOR_H_
+
+#include "generator.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include "counter_generator.h"
+#include "utils/utils.h"
+
+namespace ycsbc {
+
+///
+/// Exponentially distributed distance back from the most recent item of a
+/// counter, so that newer items are more popular. percentile percent of
+/// the picks fall within the latest range items.
+///
+class ExponentialGenerator : public Generator<uint64_t> {
+ public:
+  ExponentialGenerator(CounterGenerator &counter, double percentile, double range) :
+      basis_(counter), gamma_(-std::log(1.0 - percentile / 100.0) / range) {
+    Next();
+  }
+
+  uint64_t Next();
+  uint64_t Last() { return last_.load(std::memory_order_relaxed); }
+
+ private:
+  CounterGenerator &basis_;
+  double gamma_;
+  std::atomic<uint64_t> last_;
+};
+
+inline uint64_t ExponentialGenerator::Next() {
+  const uint64_t max = basis_.Last();
+  uint64_t distance;
+  do {
+    // 1 - u is in (0, 1], so the log is finite
+    distance = static_cast<uint64_t>(-std::log(1.0 - utils::ThreadLocalRandomDouble()) / gamma_);
+  } while (distance > max);
+  const uint64_t value = max - distance;
+  last_.store(value, std::memory_order_relaxed);
+  return value;
+}
+
+} // ycsbc
+
+#endif // YCSB_C_EXPONENTIAL_GENERATOR_H_
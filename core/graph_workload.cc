@@ -0,0 +1,358 @@
+//
+//  graph_workload.cc
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#include "graph_workload.h"
+#include "measurements.h"
+#include "scrambled_zipfian_generator.h"
+#include "uniform_generator.h"
+#include "zipfian_generator.h"
+#include "utils/timer.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <string>
+
+namespace ycsbc {
+
+const std::string GraphWorkload::MAX_DEGREE_PROPERTY = "graph.maxdegree";
+const std::string GraphWorkload::MAX_DEGREE_DEFAULT = "1000";
+
+const std::string GraphWorkload::LINK_TYPES_PROPERTY = "graph.linktypes";
+const std::string GraphWorkload::LINK_TYPES_DEFAULT = "1";
+
+const std::string GraphWorkload::RANGE_LIMIT_PROPERTY = "graph.rangelimit";
+const std::string GraphWorkload::RANGE_LIMIT_DEFAULT = "10";
+
+const std::string GraphWorkload::GET_NODE_PROPORTION_PROPERTY = "graph.getnodeproportion";
+const std::string GraphWorkload::GET_NODE_PROPORTION_DEFAULT = "0.16";
+
+const std::string GraphWorkload::ADD_LINK_PROPORTION_PROPERTY = "graph.addlinkproportion";
+const std::string GraphWorkload::ADD_LINK_PROPORTION_DEFAULT = "0.11";
+
+const std::string GraphWorkload::DELETE_LINK_PROPORTION_PROPERTY = "graph.deletelinkproportion";
+const std::string GraphWorkload::DELETE_LINK_PROPORTION_DEFAULT = "0.04";
+
+const std::string GraphWorkload::COUNT_LINKS_PROPORTION_PROPERTY = "graph.countlinksproportion";
+const std::string GraphWorkload::COUNT_LINKS_PROPORTION_DEFAULT = "0.06";
+
+const std::string GraphWorkload::GET_LINK_RANGE_PROPORTION_PROPERTY = "graph.getlinkrangeproportion";
+const std::string GraphWorkload::GET_LINK_RANGE_PROPORTION_DEFAULT = "0.63";
+
+const std::string GraphWorkload::ROWS_PROPERTY = "graph.rows";
+
+namespace {
+
+// mutations per batched write during load
+const size_t kLoadBatch = 256;
+
+const char *kNodeRow = "node";
+const char *kLinkRow = "link";
+const char *kCountRow = "count";
+
+std::string Pad(uint64_t n, size_t width) {
+  std::string s = std::to_string(n);
+  return std::string(width - std::min(width, s.size()), '0').append(s);
+}
+
+} // namespace
+
+void GraphWorkload::Init(const utils::Properties &p) {
+  CoreWorkload::Init(p);
+  if (data_integrity_) {
+    throw utils::Exception(DATA_INTEGRITY_PROPERTY + " is not supported by the graph workload");
+  }
+
+  if (field_count_ < 4) {
+    throw utils::Exception("graph workload needs fieldcount >= 4");
+  }
+  nodes_ = record_count_;
+  max_degree_ = std::stoull(p.GetProperty(MAX_DEGREE_PROPERTY, MAX_DEGREE_DEFAULT));
+  link_types_ = std::stoull(p.GetProperty(LINK_TYPES_PROPERTY, LINK_TYPES_DEFAULT));
+  range_limit_ = std::stoi(p.GetProperty(RANGE_LIMIT_PROPERTY, RANGE_LIMIT_DEFAULT));
+  if (nodes_ == 0 || max_degree_ == 0 || link_types_ == 0 || range_limit_ <= 0) {
+    throw utils::Exception("Invalid graph parameters");
+  }
+
+  graph_op_chooser_.AddValue(GET_NODE, std::stod(p.GetProperty(GET_NODE_PROPORTION_PROPERTY,
+                                                               GET_NODE_PROPORTION_DEFAULT)));
+  graph_op_chooser_.AddValue(ADD_LINK, std::stod(p.GetProperty(ADD_LINK_PROPORTION_PROPERTY,
+                                                               ADD_LINK_PROPORTION_DEFAULT)));
+  graph_op_chooser_.AddValue(DELETE_LINK, std::stod(p.GetProperty(DELETE_LINK_PROPORTION_PROPERTY,
+                                                                  DELETE_LINK_PROPORTION_DEFAULT)));
+  graph_op_chooser_.AddValue(COUNT_LINKS, std::stod(p.GetProperty(COUNT_LINKS_PROPORTION_PROPERTY,
+                                                                  COUNT_LINKS_PROPORTION_DEFAULT)));
+  graph_op_chooser_.AddValue(GET_LINK_RANGE, std::stod(p.GetProperty(GET_LINK_RANGE_PROPORTION_PROPERTY,
+                                                                     GET_LINK_RANGE_PROPORTION_DEFAULT)));
+
+  const std::string request_dist = p.GetProperty(REQUEST_DISTRIBUTION_PROPERTY, REQUEST_DISTRIBUTION_DEFAULT);
+  if (request_dist == "uniform") {
+    node_chooser_ = new UniformGenerator(0, nodes_ - 1);
+  } else if (request_dist == "zipfian") {
+    node_chooser_ = new ScrambledZipfianGenerator(0, nodes_ - 1);
+  } else {
+    throw utils::Exception("Distribution not allowed for graph: " + request_dist);
+  }
+  // power-law out-degree, as in LinkBench
+  degree_chooser_ = new ZipfianGenerator(1, std::min(max_degree_, nodes_));
+  rows_ = std::stoll(p.GetProperty(ROWS_PROPERTY, "0"));
+}
+
+void GraphWorkload::SaveState(utils::Properties &state) {
+  CoreWorkload::SaveState(state);
+  state.SetProperty(ROWS_PROPERTY, std::to_string(rows_.load()));
+}
+
+std::string GraphWorkload::NodeKey(uint64_t id) {
+  return "n" + Pad(id, 12);
+}
+
+std::string GraphWorkload::LinkKey(uint64_t id1, uint64_t type, uint64_t id2) {
+  // fixed width so that the links of one node and type are contiguous
+  return "l" + Pad(id1, 12) + ":" + Pad(type, 4) + ":" + Pad(id2, 12);
+}
+
+std::string GraphWorkload::CountKey(uint64_t id1, uint64_t type) {
+  return "c" + Pad(id1, 12) + ":" + Pad(type, 4);
+}
+
+void GraphWorkload::BuildRow(const char *kind, uint64_t id1, uint64_t type, uint64_t id3,
+                             std::vector<DB::Field> &values) {
+  BuildValues(values);
+  values[0].value = kind;
+  values[1].value = std::to_string(id1);
+  values[2].value = std::to_string(type);
+  values[3].value = std::to_string(id3);
+}
+
+bool GraphWorkload::RowMatches(const std::vector<DB::Field> &row, const char *kind, uint64_t id1,
+                               uint64_t type, uint64_t *id3) {
+  std::string fields[4];
+  for (auto &field : row) {
+    for (int i = 0; i < 4; i++) {
+      if (field.name == field_prefix_ + std::to_string(i)) {
+        fields[i] = field.value;
+      }
+    }
+  }
+  if (fields[0] != kind || fields[1] != std::to_string(id1) || fields[2] != std::to_string(type)) {
+    return false;
+  }
+  *id3 = std::stoull(fields[3]);
+  return true;
+}
+
+bool GraphWorkload::DoInsert(DB &db) {
+  const uint64_t id1 = insert_key_sequence_->Next();
+
+  std::vector<DB::Field> values;
+  BuildRow(kNodeRow, id1, 0, 0, values);
+  if (db.Insert(table_name_, NodeKey(id1), values) != DB::kOK) {
+    return false;
+  }
+
+  // distinct targets, spread round robin over the link types
+  const uint64_t degree = degree_chooser_->Next();
+  const uint64_t first = static_cast<uint64_t>(utils::ThreadLocalRandomDouble(0, nodes_));
+  std::vector<DB::Mutation> batch;
+  for (uint64_t type = 0; type < link_types_; type++) {
+    for (uint64_t j = type; j < degree; j += link_types_) {
+      const uint64_t id2 = (first + j) % nodes_;
+      batch.push_back({DB::Mutation::kInsert, LinkKey(id1, type, id2), {}});
+      BuildRow(kLinkRow, id1, type, id2, batch.back().values);
+      if (batch.size() >= kLoadBatch) {
+        if (db.BatchWrite(table_name_, batch) != DB::kOK) {
+          return false;
+        }
+        batch.clear();
+      }
+    }
+    const uint64_t count = degree > type ? (degree - type - 1) / link_types_ + 1 : 0;
+    batch.push_back({DB::Mutation::kInsert, CountKey(id1, type), {}});
+    BuildRow(kCountRow, id1, type, count, batch.back().values);
+  }
+  if (db.BatchWrite(table_name_, batch) != DB::kOK) {
+    return false;
+  }
+  // the node, its links and a count row per link type
+  rows_.fetch_add(1 + degree + link_types_, std::memory_order_relaxed);
+  return true;
+}
+
+bool GraphWorkload::DoTransaction(DB &db) {
+  DB::Status status;
+  switch (graph_op_chooser_.Next()) {
+    case GET_NODE:
+      status = GetNode(db);
+      break;
+    case ADD_LINK:
+      status = AddLink(db);
+      break;
+    case DELETE_LINK:
+      status = DeleteLink(db);
+      break;
+    case COUNT_LINKS:
+      status = CountLinks(db);
+      break;
+    case GET_LINK_RANGE:
+      status = GetLinkRange(db);
+      break;
+    default:
+      throw utils::Exception("Operation request is not recognized!");
+  }
+  return status == DB::kOK;
+}
+
+DB::Status GraphWorkload::ReadCount(DB &db, uint64_t id1, uint64_t type, int64_t *count) {
+  std::vector<DB::Field> result;
+  DB::Status s = db.Read(table_name_, CountKey(id1, type), NULL, result);
+  if (s == DB::kNotFound) {
+    *count = 0;
+    return DB::kOK;
+  }
+  uint64_t n = 0;
+  if (s == DB::kOK && !RowMatches(result, kCountRow, id1, type, &n)) {
+    return DB::kError;
+  }
+  *count = n;
+  return s;
+}
+
+DB::Status GraphWorkload::GetNode(DB &db) {
+  utils::Timer<uint64_t, std::nano> timer;
+  timer.Start();
+
+  std::vector<DB::Field> result;
+  DB::Status s = db.Read(table_name_, NodeKey(node_chooser_->Next()), NULL, result);
+
+  if (s == DB::kOK) {
+    measurements_->Report(GET_NODE, timer.End());
+  }
+  return s;
+}
+
+DB::Status GraphWorkload::AddLink(DB &db) {
+  utils::Timer<uint64_t, std::nano> timer;
+  timer.Start();
+
+  const uint64_t id1 = node_chooser_->Next();
+  const uint64_t type = static_cast<uint64_t>(utils::ThreadLocalRandomDouble(0, link_types_));
+  const uint64_t id2 = static_cast<uint64_t>(utils::ThreadLocalRandomDouble(0, nodes_));
+  // an existing link is only rewritten, so the count stays as it is
+  std::vector<DB::Field> link;
+  DB::Status s = db.Read(table_name_, LinkKey(id1, type, id2), NULL, link);
+  if (s != DB::kOK && s != DB::kNotFound) {
+    return s;
+  }
+  const bool is_new = (s == DB::kNotFound);
+  int64_t count = 0;
+  if (is_new) {
+    s = ReadCount(db, id1, type, &count);
+    if (s != DB::kOK) {
+      return s;
+    }
+  }
+
+  std::vector<DB::Mutation> batch(is_new ? 2 : 1);
+  batch[0].type = DB::Mutation::kInsert;
+  batch[0].key = LinkKey(id1, type, id2);
+  BuildRow(kLinkRow, id1, type, id2, batch[0].values);
+  if (is_new) {
+    batch[1].type = DB::Mutation::kInsert;
+    batch[1].key = CountKey(id1, type);
+    BuildRow(kCountRow, id1, type, count + 1, batch[1].values);
+  }
+  s = db.BatchWrite(table_name_, batch);
+
+  if (s == DB::kOK) {
+    if (is_new) {
+      rows_.fetch_add(1, std::memory_order_relaxed);
+    }
+    measurements_->Report(ADD_LINK, timer.End());
+  }
+  return s;
+}
+
+DB::Status GraphWorkload::DeleteLink(DB &db) {
+  utils::Timer<uint64_t, std::nano> timer;
+  timer.Start();
+
+  const uint64_t id1 = node_chooser_->Next();
+  const uint64_t type = static_cast<uint64_t>(utils::ThreadLocalRandomDouble(0, link_types_));
+  const uint64_t from = static_cast<uint64_t>(utils::ThreadLocalRandomDouble(0, nodes_));
+
+  // delete the first link at or after a random target
+  std::vector<std::vector<DB::Field>> result;
+  DB::Status s = db.Scan(table_name_, LinkKey(id1, type, from), 1, NULL, result);
+  if (s != DB::kOK) {
+    return s;
+  }
+  uint64_t id2;
+  if (result.empty() || !RowMatches(result[0], kLinkRow, id1, type, &id2)) {
+    return DB::kNotFound;
+  }
+  int64_t count;
+  s = ReadCount(db, id1, type, &count);
+  if (s != DB::kOK) {
+    return s;
+  }
+
+  std::vector<DB::Mutation> batch(2);
+  batch[0].type = DB::Mutation::kDelete;
+  batch[0].key = LinkKey(id1, type, id2);
+  batch[1].type = DB::Mutation::kInsert;
+  batch[1].key = CountKey(id1, type);
+  BuildRow(kCountRow, id1, type, std::max<int64_t>(count - 1, 0), batch[1].values);
+  s = db.BatchWrite(table_name_, batch);
+
+  if (s == DB::kOK) {
+    rows_.fetch_sub(1, std::memory_order_relaxed);
+    measurements_->Report(DELETE_LINK, timer.End());
+  }
+  return s;
+}
+
+DB::Status GraphWorkload::CountLinks(DB &db) {
+  utils::Timer<uint64_t, std::nano> timer;
+  timer.Start();
+
+  const uint64_t id1 = node_chooser_->Next();
+  const uint64_t type = static_cast<uint64_t>(utils::ThreadLocalRandomDouble(0, link_types_));
+  int64_t count;
+  DB::Status s = ReadCount(db, id1, type, &count);
+
+  if (s == DB::kOK) {
+    measurements_->Report(COUNT_LINKS, timer.End());
+  }
+  return s;
+}
+
+DB::Status GraphWorkload::GetLinkRange(DB &db) {
+  utils::Timer<uint64_t, std::nano> timer;
+  timer.Start();
+
+  const uint64_t id1 = node_chooser_->Next();
+  const uint64_t type = static_cast<uint64_t>(utils::ThreadLocalRandomDouble(0, link_types_));
+  std::vector<std::vector<DB::Field>> result;
+  DB::Status s = db.Scan(table_name_, LinkKey(id1, type, 0), range_limit_, NULL, result);
+  if (s != DB::kOK) {
+    return s;
+  }
+
+  std::vector<uint64_t> links;
+  for (auto &row : result) {
+    uint64_t id2;
+    if (!RowMatches(row, kLinkRow, id1, type, &id2)) {
+      break; // ran past the links of this node and type
+    }
+    links.push_back(id2);
+  }
+
+  measurements_->Report(GET_LINK_RANGE, timer.End());
+  return s;
+}
+
+} // ycsbc
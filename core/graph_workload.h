@@ -0,0 +1,122 @@
+//
+//  graph_workload.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_GRAPH_WORKLOAD_H_
+#define YCSB_C_GRAPH_WORKLOAD_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "core_workload.h"
+#include "db.h"
+#include "discrete_generator.h"
+#include "generator.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Social graph workload modeled on LinkBench. The graph has recordcount
+/// nodes; each node has a power-law number of outgoing links spread over
+/// graph.linktypes link types, and a count row per (node, link type). Links
+/// of one node and type share a key prefix, so link range queries are scans.
+/// Adding or deleting a link also rewrites the count row, in one batched
+/// write.
+///
+/// Every row stores its kind, source node, link type and target node (or
+/// link count) in the first four fields, so fieldcount must be at least 4.
+/// Count rows are maintained by read-modify-write without a transaction, so
+/// concurrent updates of the same node and type may leave them approximate.
+/// requestdistribution ("uniform" or "zipfian") picks the source node.
+///
+class GraphWorkload : public CoreWorkload {
+ public:
+  ///
+  /// The name of the property for the maximum out-degree of a node at load.
+  ///
+  static const std::string MAX_DEGREE_PROPERTY;
+  static const std::string MAX_DEGREE_DEFAULT;
+
+  ///
+  /// The name of the property for the number of link types.
+  ///
+  static const std::string LINK_TYPES_PROPERTY;
+  static const std::string LINK_TYPES_DEFAULT;
+
+  ///
+  /// The name of the property for the maximum number of links returned by a
+  /// link range query.
+  ///
+  static const std::string RANGE_LIMIT_PROPERTY;
+  static const std::string RANGE_LIMIT_DEFAULT;
+
+  ///
+  /// The names of the properties for the operation mix. The defaults are the
+  /// LinkBench production mix of these operations, normalized.
+  ///
+  static const std::string GET_NODE_PROPORTION_PROPERTY;
+  static const std::string GET_NODE_PROPORTION_DEFAULT;
+  static const std::string ADD_LINK_PROPORTION_PROPERTY;
+  static const std::string ADD_LINK_PROPORTION_DEFAULT;
+  static const std::string DELETE_LINK_PROPORTION_PROPERTY;
+  static const std::string DELETE_LINK_PROPORTION_DEFAULT;
+  static const std::string COUNT_LINKS_PROPORTION_PROPERTY;
+  static const std::string COUNT_LINKS_PROPORTION_DEFAULT;
+  static const std::string GET_LINK_RANGE_PROPORTION_PROPERTY;
+  static const std::string GET_LINK_RANGE_PROPORTION_DEFAULT;
+
+  ///
+  /// The name of the property for the number of node, link and count rows,
+  /// by default what the load phase left. SaveState writes it so that a
+  /// later invocation reports the space of the rows that exist.
+  ///
+  static const std::string ROWS_PROPERTY;
+
+  void Init(const utils::Properties &p) override;
+
+  bool DoInsert(DB &db) override;
+  bool DoTransaction(DB &db) override;
+  void SaveState(utils::Properties &state) override;
+  uint64_t GetLiveRecordCount() override { return std::max<int64_t>(rows_.load(), 0); }
+
+  GraphWorkload() : nodes_(0), max_degree_(0), link_types_(0), range_limit_(0),
+                    node_chooser_(nullptr), degree_chooser_(nullptr), rows_(0) {}
+  ~GraphWorkload() override {
+    delete node_chooser_;
+    delete degree_chooser_;
+  }
+
+ private:
+  std::string NodeKey(uint64_t id);
+  std::string LinkKey(uint64_t id1, uint64_t type, uint64_t id2);
+  std::string CountKey(uint64_t id1, uint64_t type);
+  void BuildRow(const char *kind, uint64_t id1, uint64_t type, uint64_t id3,
+                std::vector<DB::Field> &values);
+  bool RowMatches(const std::vector<DB::Field> &row, const char *kind, uint64_t id1, uint64_t type,
+                  uint64_t *id3);
+  DB::Status ReadCount(DB &db, uint64_t id1, uint64_t type, int64_t *count);
+
+  DB::Status GetNode(DB &db);
+  DB::Status AddLink(DB &db);
+  DB::Status DeleteLink(DB &db);
+  DB::Status CountLinks(DB &db);
+  DB::Status GetLinkRange(DB &db);
+
+  uint64_t nodes_;
+  uint64_t max_degree_;
+  uint64_t link_types_;
+  int range_limit_;
+  DiscreteGenerator<Operation> graph_op_chooser_;
+  Generator<uint64_t> *node_chooser_;
+  Generator<uint64_t> *degree_chooser_;
+  std::atomic<int64_t> rows_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_GRAPH_WORKLOAD_H_
@@ -0,0 +1,63 @@
+//
+//  hotspot_generator.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_HOTSPOT_GENERATOR_H_
+#define YCSB_C_HOTSPOT_GENERATOR_H_
+
+#include "generator.h"
+
+#include <atomic>
+#include <cstdint>
+#include "utils/utils.h"
+
+namespace ycsbc {
+
+///
+/// Picks from a hot set at the low end of the range with probability
+/// hot_op_fraction, uniformly within the hot or the cold set. The hot set
+/// holds hot_data_fraction of the range. Randomness is thread-local, so
+/// concurrent callers share no state.
+///
+class HotspotGenerator : public Generator<uint64_t> {
+ public:
+  // Both min and max are inclusive
+  HotspotGenerator(uint64_t min, uint64_t max, double hot_data_fraction, double hot_op_fraction) :
+      min_(min), hot_interval_(static_cast<uint64_t>((max - min + 1) * hot_data_fraction)),
+      cold_interval_(max - min + 1 - hot_interval_), hot_op_fraction_(hot_op_fraction) {
+    Next();
+  }
+
+  uint64_t Next();
+  uint64_t Last() { return last_.load(std::memory_order_relaxed); }
+
+ private:
+  static uint64_t Random(uint64_t n) {
+    uint64_t r = static_cast<uint64_t>(utils::ThreadLocalRandomDouble() * n);
+    return r < n ? r : n - 1;
+  }
+
+  uint64_t min_;
+  uint64_t hot_interval_;
+  uint64_t cold_interval_;
+  double hot_op_fraction_;
+  std::atomic<uint64_t> last_;
+};
+
+inline uint64_t HotspotGenerator::Next() {
+  uint64_t value;
+  if (cold_interval_ == 0 || (hot_interval_ > 0 && utils::ThreadLocalRandomDouble() < hot_op_fraction_)) {
+    value = min_ + Random(hot_interval_);
+  } else {
+    value = min_ + hot_interval_ + Random(cold_interval_);
+  }
+  last_.store(value, std::memory_order_relaxed);
+  return value;
+}
+
+} // ycsbc
+
+#endif // YCSB_C_HOTSPOT_GENERATOR_H_
@@ -0,0 +1,131 @@
+//
+//  htap_scanners.cc
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#include "htap_scanners.h"
+#include "core_workload.h"
+#include "db_factory.h"
+#include "utils/affinity.h"
+#include "utils/utils.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace ycsbc {
+
+const std::string HtapScanners::SCANNERS_PROPERTY = "htap.scanners";
+const std::string HtapScanners::SCANNERS_DEFAULT = "0";
+
+const std::string HtapScanners::MODE_PROPERTY = "htap.mode";
+const std::string HtapScanners::MODE_DEFAULT = "scan";
+
+const std::string HtapScanners::HOLD_TIME_PROPERTY = "htap.holdtime";
+const std::string HtapScanners::HOLD_TIME_DEFAULT = "10";
+
+const std::string HtapScanners::TABLE_PROPERTY = "htap.table";
+
+void HtapScanners::Init(const utils::Properties &p) {
+  props_ = p;
+  num_scanners_ = std::stoi(p.GetProperty(SCANNERS_PROPERTY, SCANNERS_DEFAULT));
+  const std::string mode = p.GetProperty(MODE_PROPERTY, MODE_DEFAULT);
+  if (mode == "scan") {
+    hold_ = false;
+  } else if (mode == "hold") {
+    hold_ = true;
+  } else {
+    throw utils::Exception("Unknown " + MODE_PROPERTY + ": " + mode);
+  }
+  hold_time_ = std::stoi(p.GetProperty(HOLD_TIME_PROPERTY, HOLD_TIME_DEFAULT));
+  table_ = p.GetProperty(TABLE_PROPERTY, p.GetProperty(CoreWorkload::TABLENAME_PROPERTY,
+                                                       CoreWorkload::TABLENAME_DEFAULT));
+  if (num_scanners_ < 0 || hold_time_ <= 0) {
+    throw utils::Exception("Invalid htap parameters");
+  }
+}
+
+void HtapScanners::Start(Measurements *measurements, std::vector<int> cpus) {
+  stop_.store(false);
+  scans_.store(0);
+  records_.store(0);
+  bytes_.store(0);
+  timer_.Start();
+  for (int i = 0; i < num_scanners_; i++) {
+    DB *db = DBFactory::CreateDB(&props_, measurements);
+    dbs_.push_back(db);
+    threads_.emplace_back(&HtapScanners::Scan, this, db, cpus);
+  }
+}
+
+void HtapScanners::Stop() {
+  if (threads_.empty()) {
+    return;
+  }
+  stop_.store(true);
+  for (std::thread &t : threads_) {
+    t.join();
+  }
+  const double runtime = timer_.End();
+  for (DB *db : dbs_) {
+    db->Cleanup();
+    delete db;
+  }
+  threads_.clear();
+  dbs_.clear();
+
+  const uint64_t records = records_.load();
+  const uint64_t bytes = bytes_.load();
+  std::cout << "HTAP scanners: " << num_scanners_ << (hold_ ? " holding" : " scanning")
+            << " table " << table_ << std::endl;
+  std::cout << "HTAP " << (hold_ ? "snapshots held" : "full scans completed") << ": "
+            << scans_.load() << std::endl;
+  std::cout << "HTAP records read: " << records << " (" << records / runtime << " records/sec)" << std::endl;
+  std::cout << "HTAP bytes read: " << bytes << " (" << bytes / runtime << " bytes/sec)" << std::endl;
+}
+
+void HtapScanners::Scan(DB *db, std::vector<int> cpus) {
+  try {
+    utils::SetThreadAffinity(cpus);
+    db->Init();
+
+    while (!stop_.load(std::memory_order_relaxed)) {
+      bool stopped = false;
+      bool visited = false;
+      DB::Status s = db->ScanAll(table_, [this, &stopped, &visited](size_t bytes) {
+        visited = true;
+        records_.fetch_add(1, std::memory_order_relaxed);
+        bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        if (hold_) {
+          // keep the iterator open, but stop promptly at the end of the phase
+          auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(hold_time_);
+          while (!stop_.load() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+          }
+          stopped = stop_.load();
+          return false;
+        }
+        stopped = stop_.load(std::memory_order_relaxed);
+        return !stopped;
+      });
+      if (s == DB::kNotImplemented) {
+        throw utils::Exception("HTAP scanners need a database with DB::ScanAll");
+      } else if (s != DB::kOK) {
+        throw utils::Exception("HTAP scan of " + table_ + " failed");
+      }
+      if (!stopped) {
+        scans_.fetch_add(1, std::memory_order_relaxed);
+      }
+      if (!visited) {
+        // nothing to scan yet
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      }
+    }
+  } catch (const utils::Exception &e) {
+    std::cerr << "Caught exception: " << e.what() << std::endl;
+    exit(1);
+  }
+}
+
+} // ycsbc
@@ -0,0 +1,100 @@
+//
+//  htap_scanners.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_HTAP_SCANNERS_H_
+#define YCSB_C_HTAP_SCANNERS_H_
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "db.h"
+#include "measurements.h"
+#include "utils/properties.h"
+#include "utils/timer.h"
+
+namespace ycsbc {
+
+///
+/// Background threads that run analytical scans next to the client threads
+/// of the transaction phase. In "scan" mode each scanner reads the whole
+/// table with DB::ScanAll over and over; in "hold" mode it opens the same
+/// long-lived iterator or read transaction, reads one record and keeps it
+/// open for htap.holdtime seconds before starting over. Either way old
+/// versions stay pinned (memtables and SST files in RocksDB, pages in LMDB),
+/// which short scans never show.
+///
+/// Scanners use handles of their own and do not report to the measurements,
+/// so client latency is reported as usual and the scanners report records
+/// and bytes read per second at the end of the phase.
+///
+class HtapScanners {
+ public:
+  ///
+  /// The name of the property for the number of scanner threads.
+  ///
+  static const std::string SCANNERS_PROPERTY;
+  static const std::string SCANNERS_DEFAULT;
+
+  ///
+  /// The name of the property for what scanners do: "scan" or "hold".
+  ///
+  static const std::string MODE_PROPERTY;
+  static const std::string MODE_DEFAULT;
+
+  ///
+  /// The name of the property for how long, in seconds, a scanner in "hold"
+  /// mode keeps its iterator open.
+  ///
+  static const std::string HOLD_TIME_PROPERTY;
+  static const std::string HOLD_TIME_DEFAULT;
+
+  ///
+  /// The name of the property for the table to scan. Defaults to the
+  /// workload table.
+  ///
+  static const std::string TABLE_PROPERTY;
+
+  void Init(const utils::Properties &p);
+
+  int num_scanners() const { return num_scanners_; }
+
+  ///
+  /// Starts the scanners, each on a new handle created with the properties
+  /// given to Init.
+  ///
+  void Start(Measurements *measurements, std::vector<int> cpus);
+
+  ///
+  /// Stops the scanners, waits for them and prints what they read.
+  ///
+  void Stop();
+
+  HtapScanners() : num_scanners_(0), hold_(false), hold_time_(0), stop_(false),
+                   scans_(0), records_(0), bytes_(0) {}
+
+ private:
+  void Scan(DB *db, std::vector<int> cpus);
+
+  utils::Properties props_;
+  int num_scanners_;
+  bool hold_;
+  int hold_time_;
+  std::string table_;
+  std::vector<DB *> dbs_;
+  std::vector<std::thread> threads_;
+  std::atomic<bool> stop_;
+  std::atomic<uint64_t> scans_;
+  std::atomic<uint64_t> records_;
+  std::atomic<uint64_t> bytes_;
+  utils::Timer<double> timer_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_HTAP_SCANNERS_H_
@@ -0,0 +1,92 @@
+//
+//  live_key_set.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_LIVE_KEY_SET_H_
+#define YCSB_C_LIVE_KEY_SET_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "utils/utils.h"
+
+namespace ycsbc {
+
+///
+/// Concurrent bitmap of deleted key numbers. Keys are live until deleted, so
+/// loaded and inserted keys need no bookkeeping. Bits are kept in chunks that
+/// are allocated on first delete, so the set grows with the key space without
+/// locks or a known upper bound.
+///
+class LiveKeySet {
+ public:
+  LiveKeySet() : chunks_{} {}
+
+  ~LiveKeySet() {
+    for (auto &chunk : chunks_) {
+      delete[] chunk.load();
+    }
+  }
+
+  bool IsLive(uint64_t key_num) const {
+    const std::atomic<uint64_t> *chunk = chunks_[ChunkIndex(key_num)].load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+      return true;
+    }
+    return (chunk[WordIndex(key_num)].load(std::memory_order_relaxed) & Bit(key_num)) == 0;
+  }
+
+  ///
+  /// Marks a key deleted. Returns false if it was deleted already, so that
+  /// concurrent deletes of the same key can be told apart.
+  ///
+  bool MarkDeleted(uint64_t key_num) {
+    std::atomic<uint64_t> &word = GetChunk(key_num)[WordIndex(key_num)];
+    return (word.fetch_or(Bit(key_num), std::memory_order_relaxed) & Bit(key_num)) == 0;
+  }
+
+  ///
+  /// Marks a key live again, e.g. when the delete that claimed it failed.
+  ///
+  void MarkLive(uint64_t key_num) {
+    std::atomic<uint64_t> &word = GetChunk(key_num)[WordIndex(key_num)];
+    word.fetch_and(~Bit(key_num), std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr int kChunkBits = 20;
+  static constexpr uint64_t kChunkKeys = uint64_t{1} << kChunkBits;
+  static constexpr uint64_t kNumChunks = uint64_t{1} << 16;
+
+  static uint64_t ChunkIndex(uint64_t key_num) {
+    if ((key_num >> kChunkBits) >= kNumChunks) {
+      throw utils::Exception("key number out of range for deletes: " + std::to_string(key_num));
+    }
+    return key_num >> kChunkBits;
+  }
+  static uint64_t WordIndex(uint64_t key_num) { return (key_num & (kChunkKeys - 1)) / 64; }
+  static uint64_t Bit(uint64_t key_num) { return uint64_t{1} << (key_num % 64); }
+
+  std::atomic<uint64_t> *GetChunk(uint64_t key_num) {
+    std::atomic<std::atomic<uint64_t> *> &slot = chunks_[ChunkIndex(key_num)];
+    std::atomic<uint64_t> *chunk = slot.load(std::memory_order_acquire);
+    if (chunk != nullptr) {
+      return chunk;
+    }
+    std::atomic<uint64_t> *fresh = new std::atomic<uint64_t>[kChunkKeys / 64]();
+    if (slot.compare_exchange_strong(chunk, fresh, std::memory_order_acq_rel)) {
+      return fresh;
+    }
+    delete[] fresh;
+    return chunk;
+  }
+
+  std::atomic<std::atomic<uint64_t> *> chunks_[kNumChunks];
+};
+
+} // ycsbc
+
+#endif // YCSB_C_LIVE_KEY_SET_H_
@@ -0,0 +1,168 @@
+//
+//  load_profile.cc
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#include "load_profile.h"
+#include "utils/affinity.h"
+#include "utils/timer.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace ycsbc {
+
+const std::string LoadProfile::FILE_PROPERTY = "limit.profile";
+
+const std::string LoadProfile::UPDATE_INTERVAL_PROPERTY = "limit.profile.update_ms";
+const std::string LoadProfile::UPDATE_INTERVAL_DEFAULT = "1";
+
+void LoadProfile::Init(const utils::Properties &p) {
+  const std::string file = p.GetProperty(FILE_PROPERTY, "");
+  std::ifstream input(file);
+  if (!input.is_open()) {
+    throw utils::Exception("failed to open: " + file);
+  }
+  std::string line;
+  while (std::getline(input, line)) {
+    line = utils::Trim(line);
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    segments_.push_back(ParseSegment(line));
+  }
+  if (segments_.empty()) {
+    throw utils::Exception("empty load profile: " + file);
+  }
+
+  update_interval_ = std::stoi(p.GetProperty(UPDATE_INTERVAL_PROPERTY, UPDATE_INTERVAL_DEFAULT));
+  if (update_interval_ <= 0) {
+    throw utils::Exception("Invalid " + UPDATE_INTERVAL_PROPERTY);
+  }
+}
+
+LoadProfile::Segment LoadProfile::ParseSegment(const std::string &line) {
+  std::istringstream ss(line);
+  std::string shape;
+  Segment s{CONSTANT, line, 0, 0, 0, 0, 0};
+  ss >> shape >> s.duration;
+  if (shape == "constant") {
+    ss >> s.a;
+    s.b = s.a;
+  } else if (shape == "linear") {
+    s.shape = LINEAR;
+    ss >> s.a >> s.b;
+  } else if (shape == "exp") {
+    s.shape = EXP;
+    ss >> s.a >> s.b;
+  } else if (shape == "burst") {
+    s.shape = BURST;
+    ss >> s.a >> s.b >> s.period >> s.length;
+  } else if (shape == "sine") {
+    s.shape = SINE;
+    ss >> s.a >> s.b >> s.period;
+  } else {
+    throw utils::Exception("Unknown load profile segment: " + line);
+  }
+  if (ss.fail() || s.duration <= 0 || s.a <= 0 || s.b < 0 ||
+      (s.shape == EXP && s.b <= 0) || ((s.shape == BURST || s.shape == SINE) && s.period <= 0)) {
+    throw utils::Exception("Invalid load profile segment: " + line);
+  }
+  return s;
+}
+
+int64_t LoadProfile::Rate(const Segment &s, int64_t t) {
+  const double x = static_cast<double>(t) / s.duration;
+  double rate = s.a;
+  switch (s.shape) {
+    case CONSTANT:
+      break;
+    case LINEAR:
+      rate = s.a + (s.b - s.a) * x;
+      break;
+    case EXP:
+      rate = s.a * std::pow(s.b / s.a, x);
+      break;
+    case BURST:
+      rate = (t % s.period < s.length) ? s.b : s.a;
+      break;
+    case SINE:
+      rate = s.a + s.b * std::sin(2 * M_PI * t / s.period);
+      break;
+  }
+  // a rate of 0 would lift the limit altogether
+  return std::max<int64_t>(1, std::llround(rate));
+}
+
+void LoadProfile::Run(Measurements *measurements, utils::RateLimiter *rlim, std::atomic<bool> *stop,
+                      std::vector<int> cpus) {
+  try {
+    utils::SetThreadAffinity(cpus);
+    // measure each segment on its own, keeping the whole run for the final report
+    IntervalMeasurements *phase = dynamic_cast<IntervalMeasurements *>(measurements);
+    if (phase == nullptr) {
+      throw utils::Exception("load profile needs interval measurements");
+    }
+    Measurements *interval = phase->OpenInterval();
+    Play(interval, rlim);
+    phase->CloseInterval(interval);
+  } catch (const utils::Exception &e) {
+    std::cerr << "Caught exception: " << e.what() << std::endl;
+    exit(1);
+  }
+  stop->store(true);
+}
+
+void LoadProfile::Play(Measurements *interval, utils::RateLimiter *rlim) {
+  using Clock = std::chrono::steady_clock;
+  struct Result {
+    double target;
+    double achieved;
+    std::string latency;
+  };
+  std::vector<Result> results;
+
+  for (const Segment &s : segments_) {
+    interval->Reset();
+    utils::Timer<double> timer;
+    timer.Start();
+
+    // step through the segment on a fixed grid so that late wakeups do not accumulate
+    const Clock::time_point start = Clock::now();
+    double rate_sum = 0;
+    for (int64_t t = 0; t < s.duration; t += update_interval_) {
+      std::this_thread::sleep_until(start + std::chrono::milliseconds(t));
+      int64_t rate = Rate(s, t);
+      rlim->SetRate(rate);
+      rate_sum += static_cast<double>(rate) * std::min<int64_t>(update_interval_, s.duration - t);
+    }
+    std::this_thread::sleep_until(start + std::chrono::milliseconds(s.duration));
+    double runtime = timer.End();
+
+    Result r;
+    r.target = rate_sum / s.duration;
+    r.achieved = interval->GetClientOps() / runtime;
+    r.latency = interval->GetStatusMsg();
+    results.push_back(r);
+
+    std::cout << "Profile segment: " << s.line << std::endl;
+    std::cout << "  target(ops/sec)=" << r.target << " achieved(ops/sec)=" << r.achieved << std::endl;
+    std::cout << "  latency(us): " << r.latency << std::endl;
+  }
+
+  std::cout << "Profile summary: segment target(ops/sec) achieved(ops/sec)" << std::endl;
+  for (size_t i = 0; i < segments_.size(); i++) {
+    std::cout << "  " << i << ' ' << results[i].target << ' ' << results[i].achieved
+              << " [" << segments_[i].line << "]" << std::endl;
+  }
+}
+
+} // ycsbc
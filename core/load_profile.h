@@ -0,0 +1,84 @@
+//
+//  load_profile.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_LOAD_PROFILE_H_
+#define YCSB_C_LOAD_PROFILE_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "measurements.h"
+#include "utils/properties.h"
+#include "utils/rate_limit.h"
+
+namespace ycsbc {
+
+///
+/// Drives the client rate limiter through a scripted sequence of segments
+/// and reports target and achieved throughput and latency per segment.
+///
+/// Each non-empty line of the profile file that does not start with '#'
+/// describes one segment, with durations in milliseconds:
+///
+///   constant <duration> <rate>
+///   linear <duration> <from_rate> <to_rate>
+///   exp <duration> <from_rate> <to_rate>
+///   burst <duration> <base_rate> <peak_rate> <period> <burst_length>
+///   sine <duration> <mean_rate> <amplitude> <period>
+///
+class LoadProfile {
+ public:
+  ///
+  /// The name of the property for the profile file.
+  ///
+  static const std::string FILE_PROPERTY;
+
+  ///
+  /// The name of the property for how often the rate is updated, in
+  /// milliseconds.
+  ///
+  static const std::string UPDATE_INTERVAL_PROPERTY;
+  static const std::string UPDATE_INTERVAL_DEFAULT;
+
+  void Init(const utils::Properties &p);
+
+  int64_t start_rate() const { return Rate(segments_[0], 0); }
+
+  ///
+  /// Plays the profile, then raises stop so that client threads finish.
+  /// Each segment is measured on an interval of measurements, which must be
+  /// IntervalMeasurements as CreateMeasurements makes them.
+  ///
+  void Run(Measurements *measurements, utils::RateLimiter *rlim, std::atomic<bool> *stop,
+           std::vector<int> cpus);
+
+ private:
+  enum Shape { CONSTANT, LINEAR, EXP, BURST, SINE };
+
+  struct Segment {
+    Shape shape;
+    std::string line;
+    int64_t duration;
+    double a;
+    double b;
+    int64_t period;
+    int64_t length;
+  };
+
+  static Segment ParseSegment(const std::string &line);
+  static int64_t Rate(const Segment &s, int64_t t);
+
+  void Play(Measurements *interval, utils::RateLimiter *rlim);
+
+  std::vector<Segment> segments_;
+  int update_interval_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_LOAD_PROFILE_H_
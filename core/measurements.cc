@@ -8,6 +8,7 @@
 #include "measurements.h"
 #include "utils/utils.h"
 
+#include <cassert>
 #include <limits>
 #include <numeric>
 #include <sstream>
@@ -23,7 +24,7 @@ namespace {
 
 namespace ycsbc {
 
-BasicMeasurements::BasicMeasurements() : count_{}, latency_sum_{}, latency_max_{} {
+BasicMeasurements::BasicMeasurements() : count_{}, latency_sum_{}, latency_max_{}, client_ops_(0) {
   std::fill(std::begin(latency_min_), std::end(latency_min_), std::numeric_limits<uint64_t>::max());
 }
 
@@ -67,10 +68,32 @@ void BasicMeasurements::Reset() {
   std::fill(std::begin(latency_sum_), std::end(latency_sum_), 0);
   std::fill(std::begin(latency_min_), std::end(latency_min_), std::numeric_limits<uint64_t>::max());
   std::fill(std::begin(latency_max_), std::end(latency_max_), 0);
+  client_ops_ = 0;
+}
+
+uint64_t BasicMeasurements::GetCount(Operation op) {
+  return count_[op].load(std::memory_order_relaxed);
+}
+
+uint64_t BasicMeasurements::GetLatencyPercentile(Operation op, double percentile) {
+  if (percentile <= 0) {
+    return latency_min_[op].load(std::memory_order_relaxed);
+  } else if (percentile >= 100) {
+    return latency_max_[op].load(std::memory_order_relaxed);
+  }
+  throw utils::Exception("basic measurements only track min and max latency");
+}
+
+void BasicMeasurements::ReportClientOp() {
+  client_ops_.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t BasicMeasurements::GetClientOps() {
+  return client_ops_.load(std::memory_order_relaxed);
 }
 
 #ifdef HDRMEASUREMENT
-HdrHistogramMeasurements::HdrHistogramMeasurements() {
+HdrHistogramMeasurements::HdrHistogramMeasurements() : client_ops_(0) {
   for (int op = 0; op < MAXOPTYPE; op++) {
     if (hdr_init(10, 100LL * 1000 * 1000 * 1000, 3, &histogram_[op]) != 0) {
       utils::Exception("hdr init failed");
@@ -111,24 +134,225 @@ void HdrHistogramMeasurements::Reset() {
   for (int op = 0; op < MAXOPTYPE; op++) {
     hdr_reset(histogram_[op]);
   }
+  client_ops_ = 0;
+}
+
+uint64_t HdrHistogramMeasurements::GetCount(Operation op) {
+  return histogram_[op]->total_count;
+}
+
+uint64_t HdrHistogramMeasurements::GetLatencyPercentile(Operation op, double percentile) {
+  return hdr_value_at_percentile(histogram_[op], percentile);
+}
+
+void HdrHistogramMeasurements::ReportClientOp() {
+  client_ops_.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t HdrHistogramMeasurements::GetClientOps() {
+  return client_ops_.load(std::memory_order_relaxed);
 }
 #endif
 
-Measurements *CreateMeasurements(utils::Properties *props) {
-  std::string name = props->GetProperty(MEASUREMENT_TYPE, MEASUREMENT_TYPE_DEFAULT);
+TableMeasurements::TableMeasurements(Measurements *total, const std::vector<std::string> &tables,
+                                     const std::vector<Measurements *> &per_table)
+    : total_(total), tables_(tables), per_table_(per_table) {
+  assert(tables_.size() == per_table_.size());
+}
+
+TableMeasurements::~TableMeasurements() {
+  delete total_;
+  for (Measurements *m : per_table_) {
+    delete m;
+  }
+}
+
+void TableMeasurements::Report(Operation op, uint64_t latency) {
+  total_->Report(op, latency);
+}
 
-  Measurements *measurements;
+void TableMeasurements::ReportTable(const std::string &table, Operation op, uint64_t latency) {
+  total_->Report(op, latency);
+  // a handful of tables, a linear search beats hashing the name
+  for (size_t i = 0; i < tables_.size(); i++) {
+    if (tables_[i] == table) {
+      per_table_[i]->Report(op, latency);
+      break;
+    }
+  }
+}
+
+std::string TableMeasurements::GetStatusMsg() {
+  std::string msg = total_->GetStatusMsg();
+  for (size_t i = 0; i < tables_.size(); i++) {
+    msg += " {" + tables_[i] + ": " + per_table_[i]->GetStatusMsg() + "}";
+  }
+  return msg;
+}
+
+void TableMeasurements::Reset() {
+  total_->Reset();
+  for (Measurements *m : per_table_) {
+    m->Reset();
+  }
+}
+
+uint64_t TableMeasurements::GetCount(Operation op) {
+  return total_->GetCount(op);
+}
+
+uint64_t TableMeasurements::GetLatencyPercentile(Operation op, double percentile) {
+  return total_->GetLatencyPercentile(op, percentile);
+}
+
+void TableMeasurements::ReportClientOp() {
+  total_->ReportClientOp();
+}
+
+uint64_t TableMeasurements::GetClientOps() {
+  return total_->GetClientOps();
+}
+
+namespace {
+
+Measurements *CreateNamedMeasurements(const std::string &name) {
   if (name == "basic") {
-    measurements = new BasicMeasurements();
+    return new BasicMeasurements();
 #ifdef HDRMEASUREMENT
   } else if (name == "hdrhistogram") {
-    measurements = new HdrHistogramMeasurements();
+    return new HdrHistogramMeasurements();
 #endif
+  }
+  return nullptr;
+}
+
+} // anonymous
+
+IntervalMeasurements::IntervalMeasurements(Measurements *total, const std::string &type)
+    : total_(total), type_(type), intervals_{} {
+}
+
+IntervalMeasurements::~IntervalMeasurements() {
+  delete total_;
+  for (auto &interval : intervals_) {
+    delete interval.load();
+  }
+  for (Measurements *m : closed_) {
+    delete m;
+  }
+}
+
+void IntervalMeasurements::Report(Operation op, uint64_t latency) {
+  total_->Report(op, latency);
+  for (auto &slot : intervals_) {
+    Measurements *interval = slot.load(std::memory_order_acquire);
+    if (interval != nullptr) {
+      interval->Report(op, latency);
+    }
+  }
+}
+
+void IntervalMeasurements::ReportTable(const std::string &table, Operation op, uint64_t latency) {
+  total_->ReportTable(table, op, latency);
+  for (auto &slot : intervals_) {
+    Measurements *interval = slot.load(std::memory_order_acquire);
+    if (interval != nullptr) {
+      interval->Report(op, latency);
+    }
+  }
+}
+
+std::string IntervalMeasurements::GetStatusMsg() {
+  return total_->GetStatusMsg();
+}
+
+void IntervalMeasurements::Reset() {
+  total_->Reset();
+  for (auto &slot : intervals_) {
+    Measurements *interval = slot.load(std::memory_order_acquire);
+    if (interval != nullptr) {
+      interval->Reset();
+    }
+  }
+}
+
+uint64_t IntervalMeasurements::GetCount(Operation op) {
+  return total_->GetCount(op);
+}
+
+uint64_t IntervalMeasurements::GetLatencyPercentile(Operation op, double percentile) {
+  return total_->GetLatencyPercentile(op, percentile);
+}
+
+void IntervalMeasurements::ReportClientOp() {
+  total_->ReportClientOp();
+  for (auto &slot : intervals_) {
+    Measurements *interval = slot.load(std::memory_order_acquire);
+    if (interval != nullptr) {
+      interval->ReportClientOp();
+    }
+  }
+}
+
+uint64_t IntervalMeasurements::GetClientOps() {
+  return total_->GetClientOps();
+}
+
+Measurements *IntervalMeasurements::OpenInterval() {
+  std::lock_guard<std::mutex> lock(mu_);
+  Measurements *interval;
+  if (closed_.empty()) {
+    interval = CreateNamedMeasurements(type_);
   } else {
-    measurements = nullptr;
+    interval = closed_.back();
+    closed_.pop_back();
+    interval->Reset();
+  }
+  for (auto &slot : intervals_) {
+    if (slot.load(std::memory_order_relaxed) == nullptr) {
+      slot.store(interval, std::memory_order_release);
+      return interval;
+    }
+  }
+  closed_.push_back(interval);
+  throw utils::Exception("too many measurement intervals open");
+}
+
+void IntervalMeasurements::CloseInterval(Measurements *interval) {
+  std::lock_guard<std::mutex> lock(mu_);
+  for (auto &slot : intervals_) {
+    if (slot.load(std::memory_order_relaxed) == interval) {
+      slot.store(nullptr, std::memory_order_release);
+      closed_.push_back(interval);
+      return;
+    }
+  }
+}
+
+Measurements *CreateMeasurements(utils::Properties *props) {
+  std::string name = props->GetProperty(MEASUREMENT_TYPE, MEASUREMENT_TYPE_DEFAULT);
+
+  Measurements *measurements = CreateNamedMeasurements(name);
+  if (measurements == nullptr) {
+    return nullptr;
+  }
+
+  // break latency down by table
+  if (!props->GetProperty(CoreWorkload::TABLES_PROPERTY).empty()) {
+    std::vector<std::string> tables = CoreWorkload::GetTableNames(*props);
+    std::vector<Measurements *> per_table;
+    for (size_t i = 0; i < tables.size(); i++) {
+      per_table.push_back(CreateNamedMeasurements(name));
+    }
+    measurements = new TableMeasurements(measurements, tables, per_table);
   }
 
-  return measurements;
+  // for samplers that follow latency over time
+  return new IntervalMeasurements(measurements, name);
+}
+
+bool HasPercentiles(const utils::Properties &props) {
+  return props.GetProperty(MEASUREMENT_TYPE, MEASUREMENT_TYPE_DEFAULT) != "basic";
 }
 
 } // ycsbc
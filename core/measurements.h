@@ -12,6 +12,9 @@
 #include "utils/properties.h"
 
 #include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #ifdef HDRMEASUREMENT
 #include <hdr/hdr_histogram.h>
@@ -23,9 +26,35 @@ namespace ycsbc {
 
 class Measurements {
  public:
+  virtual ~Measurements() {}
   virtual void Report(Operation op, uint64_t latency) = 0;
+  ///
+  /// Reports an operation on the given table. Only measurements that break
+  /// latency down by table look at the table.
+  ///
+  virtual void ReportTable(const std::string &table, Operation op, uint64_t latency) {
+    Report(op, latency);
+  }
   virtual std::string GetStatusMsg() = 0;
   virtual void Reset() = 0;
+  ///
+  /// Number of samples reported for op since the last reset.
+  ///
+  virtual uint64_t GetCount(Operation op) = 0;
+  ///
+  /// Latency in nanoseconds at the given percentile of op's samples.
+  ///
+  virtual uint64_t GetLatencyPercentile(Operation op, double percentile) = 0;
+  ///
+  /// Counts one operation of a client thread. It may span several of the
+  /// operations reported above, e.g. a dequeue or a transaction, so
+  /// throughput is computed from this count rather than from theirs.
+  ///
+  virtual void ReportClientOp() = 0;
+  ///
+  /// Number of client operations counted since the last reset.
+  ///
+  virtual uint64_t GetClientOps() = 0;
 };
 
 class BasicMeasurements : public Measurements {
@@ -34,11 +63,16 @@ class BasicMeasurements : public Measurements {
   void Report(Operation op, uint64_t latency) override;
   std::string GetStatusMsg() override;
   void Reset() override;
+  uint64_t GetCount(Operation op) override;
+  uint64_t GetLatencyPercentile(Operation op, double percentile) override;
+  void ReportClientOp() override;
+  uint64_t GetClientOps() override;
  private:
   std::atomic<uint> count_[MAXOPTYPE];
   std::atomic<uint64_t> latency_sum_[MAXOPTYPE];
   std::atomic<uint64_t> latency_min_[MAXOPTYPE];
   std::atomic<uint64_t> latency_max_[MAXOPTYPE];
+  std::atomic<uint64_t> client_ops_;
 };
 
 #ifdef HDRMEASUREMENT
@@ -48,13 +82,91 @@ class HdrHistogramMeasurements : public Measurements {
   void Report(Operation op, uint64_t latency) override;
   std::string GetStatusMsg() override;
   void Reset() override;
+  uint64_t GetCount(Operation op) override;
+  uint64_t GetLatencyPercentile(Operation op, double percentile) override;
+  void ReportClientOp() override;
+  uint64_t GetClientOps() override;
  private:
   hdr_histogram *histogram_[MAXOPTYPE];
+  std::atomic<uint64_t> client_ops_;
 };
 #endif
 
+///
+/// Keeps the latency of each table of a multi-table run next to the totals.
+/// Counts and percentiles are those of the totals; the status message lists
+/// the totals and then each table.
+///
+class TableMeasurements : public Measurements {
+ public:
+  TableMeasurements(Measurements *total, const std::vector<std::string> &tables,
+                    const std::vector<Measurements *> &per_table);
+  ~TableMeasurements() override;
+  void Report(Operation op, uint64_t latency) override;
+  void ReportTable(const std::string &table, Operation op, uint64_t latency) override;
+  std::string GetStatusMsg() override;
+  void Reset() override;
+  uint64_t GetCount(Operation op) override;
+  uint64_t GetLatencyPercentile(Operation op, double percentile) override;
+  void ReportClientOp() override;
+  uint64_t GetClientOps() override;
+ private:
+  Measurements *total_;
+  std::vector<std::string> tables_;
+  std::vector<Measurements *> per_table_;
+};
+
+///
+/// Keeps the samples of the whole phase and passes them on to the intervals
+/// that samplers open, so that a sampler can follow latency over time without
+/// resetting what the phase reports. Counts, percentiles and the status
+/// message are those of the whole phase.
+///
+class IntervalMeasurements : public Measurements {
+ public:
+  IntervalMeasurements(Measurements *total, const std::string &type);
+  ~IntervalMeasurements() override;
+  void Report(Operation op, uint64_t latency) override;
+  void ReportTable(const std::string &table, Operation op, uint64_t latency) override;
+  std::string GetStatusMsg() override;
+  void Reset() override;
+  uint64_t GetCount(Operation op) override;
+  uint64_t GetLatencyPercentile(Operation op, double percentile) override;
+  void ReportClientOp() override;
+  uint64_t GetClientOps() override;
+
+  ///
+  /// Opens an interval, which receives every sample from now on until
+  /// CloseInterval. The sampler resets it whenever it starts a new interval.
+  ///
+  Measurements *OpenInterval();
+  ///
+  /// Stops passing samples to interval. An operation in flight may still
+  /// report to it, so it is kept for the next OpenInterval.
+  ///
+  void CloseInterval(Measurements *interval);
+ private:
+  // the warm-up curve, the event timeline, and the SLO search or load profile
+  static const int kMaxIntervals = 4;
+
+  Measurements *total_;
+  std::string type_;
+  std::atomic<Measurements *> intervals_[kMaxIntervals];
+  std::mutex mu_;
+  std::vector<Measurements *> closed_;
+};
+
+///
+/// Makes the measurements of measurementtype, as IntervalMeasurements.
+///
 Measurements *CreateMeasurements(utils::Properties *props);
 
+///
+/// Whether the measurements CreateMeasurements makes from props keep
+/// percentiles other than the min and the max.
+///
+bool HasPercentiles(const utils::Properties &props);
+
 } // ycsbc
 
 #endif // YCSB_C_MEASUREMENTS
@@ -0,0 +1,70 @@
+//
+//  moving_hotspot_generator.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_MOVING_HOTSPOT_GENERATOR_H_
+#define YCSB_C_MOVING_HOTSPOT_GENERATOR_H_
+
+#include "generator.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "utils/utils.h"
+
+namespace ycsbc {
+
+///
+/// Hotspot whose hot set slides through the range at a fixed speed and
+/// wraps around at the end, so that what is cached keeps going cold. The
+/// position is derived from the time since construction, so concurrent
+/// callers share no mutable state.
+///
+class MovingHotspotGenerator : public Generator<uint64_t> {
+ public:
+  // Both min and max are inclusive, speed is in items per second
+  MovingHotspotGenerator(uint64_t min, uint64_t max, double hot_data_fraction, double hot_op_fraction,
+                         double speed) :
+      min_(min), items_(max - min + 1), hot_interval_(static_cast<uint64_t>(items_ * hot_data_fraction)),
+      hot_op_fraction_(hot_op_fraction), speed_(speed), start_(std::chrono::steady_clock::now()) {
+    Next();
+  }
+
+  uint64_t Next();
+  uint64_t Last() { return last_.load(std::memory_order_relaxed); }
+
+ private:
+  static uint64_t Random(uint64_t n) {
+    uint64_t r = static_cast<uint64_t>(utils::ThreadLocalRandomDouble() * n);
+    return r < n ? r : n - 1;
+  }
+
+  uint64_t min_;
+  uint64_t items_;
+  uint64_t hot_interval_;
+  double hot_op_fraction_;
+  double speed_;
+  std::chrono::steady_clock::time_point start_;
+  std::atomic<uint64_t> last_;
+};
+
+inline uint64_t MovingHotspotGenerator::Next() {
+  const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+  const uint64_t offset = static_cast<uint64_t>(elapsed * speed_) % items_;
+  uint64_t value;
+  if (hot_interval_ == items_ || (hot_interval_ > 0 && utils::ThreadLocalRandomDouble() < hot_op_fraction_)) {
+    value = offset + Random(hot_interval_);
+  } else {
+    value = offset + hot_interval_ + Random(items_ - hot_interval_);
+  }
+  value = min_ + value % items_;
+  last_.store(value, std::memory_order_relaxed);
+  return value;
+}
+
+} // ycsbc
+
+#endif // YCSB_C_MOVING_HOTSPOT_GENERATOR_H_
@@ -0,0 +1,113 @@
+//
+//  multi_table_workload.cc
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#include "multi_table_workload.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <string>
+
+namespace ycsbc {
+
+const std::string MultiTableWorkload::TABLE_PROPORTION_PROPERTY = "tableproportion";
+const std::string MultiTableWorkload::TABLE_PROPORTION_DEFAULT = "1";
+
+void MultiTableWorkload::Init(const utils::Properties &p) {
+  CoreWorkload::Init(p);
+
+  uint64_t records = 0;
+  bool has_operations = false;
+  table_names_ = GetTableNames(p);
+  for (const std::string &table : table_names_) {
+    utils::Properties table_props = GetTableProperties(p, table);
+    CoreWorkload *wl = CreateWorkload(table_props, measurements_);
+    if (wl == nullptr) {
+      throw utils::Exception("Unknown workload name for table " + table + ": "
+                             + table_props.GetProperty(WORKLOAD_PROPERTY));
+    }
+    tables_.push_back(wl);
+    wl->Init(table_props);
+
+    records += wl->GetLoadRecordCount();
+    load_records_.push_back(records);
+
+    double proportion = std::stod(table_props.GetProperty(TABLE_PROPORTION_PROPERTY,
+                                                          TABLE_PROPORTION_DEFAULT));
+    if (proportion < 0) {
+      throw utils::Exception("Invalid " + TABLE_PROPORTION_PROPERTY + " for table " + table);
+    }
+    if (proportion > 0) {
+      table_chooser_.AddValue(tables_.size() - 1, proportion);
+      has_operations = true;
+    }
+  }
+  if (!has_operations) {
+    throw utils::Exception("No table has a positive " + TABLE_PROPORTION_PROPERTY);
+  }
+}
+
+bool MultiTableWorkload::DoInsert(DB &db) {
+  // the first records go to the first table, the next ones to the second, and so on
+  const uint64_t n = load_sequence_.fetch_add(1, std::memory_order_relaxed);
+  size_t i = std::upper_bound(load_records_.begin(), load_records_.end(), n) - load_records_.begin();
+  return tables_[std::min(i, tables_.size() - 1)]->DoInsert(db);
+}
+
+bool MultiTableWorkload::DoTransaction(DB &db) {
+  return tables_[table_chooser_.Next()]->DoTransaction(db);
+}
+
+void MultiTableWorkload::FinishRun(DB &db) {
+  for (CoreWorkload *wl : tables_) {
+    wl->FinishRun(db);
+  }
+}
+
+uint64_t MultiTableWorkload::GetVerifyRecordCount() {
+  uint64_t records = 0;
+  verify_records_.clear();
+  for (CoreWorkload *wl : tables_) {
+    records += wl->GetVerifyRecordCount();
+    verify_records_.push_back(records);
+  }
+  verify_sequence_.store(0);
+  return records;
+}
+
+uint64_t MultiTableWorkload::GetLiveRecordCount() {
+  uint64_t records = 0;
+  for (CoreWorkload *wl : tables_) {
+    records += wl->GetLiveRecordCount();
+  }
+  return records;
+}
+
+bool MultiTableWorkload::DoVerify(DB &db) {
+  const uint64_t n = verify_sequence_.fetch_add(1, std::memory_order_relaxed);
+  size_t i = std::upper_bound(verify_records_.begin(), verify_records_.end(), n) - verify_records_.begin();
+  return tables_[std::min(i, tables_.size() - 1)]->DoVerify(db);
+}
+
+bool MultiTableWorkload::FinishVerify() {
+  bool ok = true;
+  for (CoreWorkload *wl : tables_) {
+    ok &= wl->FinishVerify();
+  }
+  return ok;
+}
+
+void MultiTableWorkload::SaveState(utils::Properties &state) {
+  // each table continues from its own state, which the table prefix
+  // applies to that table only
+  for (size_t i = 0; i < tables_.size(); i++) {
+    utils::Properties table_state;
+    tables_[i]->SaveState(table_state);
+    state.SetPrefixed(table_names_[i] + ".", table_state);
+  }
+}
+
+} // ycsbc
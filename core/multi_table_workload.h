@@ -0,0 +1,77 @@
+//
+//  multi_table_workload.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_MULTI_TABLE_WORKLOAD_H_
+#define YCSB_C_MULTI_TABLE_WORKLOAD_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "core_workload.h"
+#include "db.h"
+#include "discrete_generator.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Runs one workload per table of the "tables" list against the same
+/// database, so that the tables compete for its cache and background work.
+/// Each table has its own record count, field schema, key distribution and
+/// operation mix, set by properties prefixed with the table name, e.g.
+/// "orders.recordcount=1000000" or "orders.requestdistribution=zipfian";
+/// "<table>.workload" picks the workload class of a table.
+///
+/// The load phase inserts the records of every table. In the transaction
+/// phase, each operation goes to a table picked with probability
+/// proportional to "<table>.tableproportion". The verify phase checks the
+/// records of every table.
+///
+class MultiTableWorkload : public CoreWorkload {
+ public:
+  ///
+  /// The name of the property for the share of the operations that go to a
+  /// table, relative to the other tables. Set per table with the table name
+  /// as prefix.
+  ///
+  static const std::string TABLE_PROPORTION_PROPERTY;
+  static const std::string TABLE_PROPORTION_DEFAULT;
+
+  void Init(const utils::Properties &p) override;
+
+  bool DoInsert(DB &db) override;
+  bool DoTransaction(DB &db) override;
+  void FinishRun(DB &db) override;
+  bool DoVerify(DB &db) override;
+  bool FinishVerify() override;
+  uint64_t GetVerifyRecordCount() override;
+  uint64_t GetLiveRecordCount() override;
+  void SaveState(utils::Properties &state) override;
+
+  uint64_t GetLoadRecordCount() override { return load_records_.empty() ? 0 : load_records_.back(); }
+
+  MultiTableWorkload() : load_sequence_(0), verify_sequence_(0) {}
+  ~MultiTableWorkload() override {
+    for (CoreWorkload *wl : tables_) {
+      delete wl;
+    }
+  }
+
+ private:
+  std::vector<std::string> table_names_;
+  std::vector<CoreWorkload *> tables_;
+  std::vector<uint64_t> load_records_; // records loaded by this table and the ones before it
+  std::atomic<uint64_t> load_sequence_;
+  std::vector<uint64_t> verify_records_; // records verified in this table and the ones before it
+  std::atomic<uint64_t> verify_sequence_;
+  DiscreteGenerator<size_t> table_chooser_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_MULTI_TABLE_WORKLOAD_H_
@@ -0,0 +1,195 @@
+//
+//  queue_workload.cc
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#include "queue_workload.h"
+#include "measurements.h"
+#include "utils/timer.h"
+#include "utils/utils.h"
+
+#include <chrono>
+#include <string>
+
+namespace ycsbc {
+
+const std::string QueueWorkload::ENQUEUE_PROPORTION_PROPERTY = "queue.enqueueproportion";
+const std::string QueueWorkload::ENQUEUE_PROPORTION_DEFAULT = "0.5";
+
+const std::string QueueWorkload::MAX_DEPTH_PROPERTY = "queue.maxdepth";
+const std::string QueueWorkload::MAX_DEPTH_DEFAULT = "0";
+
+const std::string QueueWorkload::CONSUMER_LAG_PROPERTY = "queue.consumerlag_ms";
+const std::string QueueWorkload::CONSUMER_LAG_DEFAULT = "0";
+
+const std::string QueueWorkload::SEEK_FROM_PROPERTY = "queue.seekfrom";
+const std::string QueueWorkload::SEEK_FROM_DEFAULT = "start";
+
+const std::string QueueWorkload::SCAN_LENGTH_PROPERTY = "queue.scanlength";
+const std::string QueueWorkload::SCAN_LENGTH_DEFAULT = "16";
+
+const std::string QueueWorkload::HEAD_PROPERTY = "queue.head";
+const std::string QueueWorkload::TAIL_PROPERTY = "queue.tail";
+const std::string QueueWorkload::DEPTH_PROPERTY = "queue.depth";
+
+namespace {
+
+uint64_t NowNanos() {
+  // wall clock, so that ages stay meaningful across load and run invocations
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+void QueueWorkload::Init(const utils::Properties &p) {
+  CoreWorkload::Init(p);
+  if (data_integrity_) {
+    throw utils::Exception(DATA_INTEGRITY_PROPERTY + " is not supported by the queue workload");
+  }
+
+  if (field_count_ < 2) {
+    throw utils::Exception("queue workload needs fieldcount >= 2");
+  }
+  enqueue_proportion_ = std::stod(p.GetProperty(ENQUEUE_PROPORTION_PROPERTY, ENQUEUE_PROPORTION_DEFAULT));
+  max_depth_ = std::stoll(p.GetProperty(MAX_DEPTH_PROPERTY, MAX_DEPTH_DEFAULT));
+  consumer_lag_ = std::stoull(p.GetProperty(CONSUMER_LAG_PROPERTY, CONSUMER_LAG_DEFAULT)) * 1000000;
+  scan_length_ = std::stoi(p.GetProperty(SCAN_LENGTH_PROPERTY, SCAN_LENGTH_DEFAULT));
+  // queues that share a table need prefixes of their own
+  key_prefix_ = p.GetProperty(KEY_PREFIX_PROPERTY, "queue");
+
+  const std::string seek_from = p.GetProperty(SEEK_FROM_PROPERTY, SEEK_FROM_DEFAULT);
+  if (seek_from == "start") {
+    seek_from_head_ = false;
+  } else if (seek_from == "head") {
+    seek_from_head_ = true;
+  } else {
+    throw utils::Exception("Unknown " + SEEK_FROM_PROPERTY + ": " + seek_from);
+  }
+
+  // the queue holds what the load phase inserted, or what the saved state says
+  first_seq_ = std::stoull(p.GetProperty(INSERT_START_PROPERTY, INSERT_START_DEFAULT));
+  head_ = std::stoull(p.GetProperty(HEAD_PROPERTY, std::to_string(first_seq_)));
+  depth_ = std::stoll(p.GetProperty(DEPTH_PROPERTY, std::to_string(record_count_)));
+
+  // tracks claimed messages so that concurrent consumers never take the same one
+  if (live_keys_ == nullptr) {
+    live_keys_ = new LiveKeySet();
+  }
+}
+
+uint64_t QueueWorkload::TransactionInsertStart(const utils::Properties &p) {
+  // after the messages the load phase inserted from insertstart
+  return std::stoull(p.GetProperty(TAIL_PROPERTY, std::to_string(insert_start_ + record_count_)));
+}
+
+std::string QueueWorkload::QueueKey(uint64_t seq) {
+  // fixed width so that key order is message order
+  std::string value = std::to_string(seq);
+  return std::string(key_prefix_).append(20 - value.size(), '0').append(value);
+}
+
+void QueueWorkload::BuildMessage(uint64_t seq, std::vector<DB::Field> &values) {
+  BuildValues(values);
+  values[0].value = std::to_string(seq);
+  values[1].value = std::to_string(NowNanos());
+}
+
+bool QueueWorkload::DoInsert(DB &db) {
+  const uint64_t seq = insert_key_sequence_->Next();
+  std::vector<DB::Field> values;
+  BuildMessage(seq, values);
+  return db.Insert(table_name_, QueueKey(seq), values) == DB::kOK;
+}
+
+void QueueWorkload::SaveState(utils::Properties &state) {
+  CoreWorkload::SaveState(state);
+  state.SetProperty(HEAD_PROPERTY, std::to_string(head_.load()));
+  state.SetProperty(TAIL_PROPERTY, std::to_string(transaction_insert_key_sequence_->Last() + 1));
+  state.SetProperty(DEPTH_PROPERTY, std::to_string(depth_.load()));
+}
+
+bool QueueWorkload::DoTransaction(DB &db) {
+  bool enqueue = utils::ThreadLocalRandomDouble() < enqueue_proportion_;
+  if (enqueue && max_depth_ > 0 && depth_.load(std::memory_order_relaxed) >= max_depth_) {
+    enqueue = false;
+  }
+  DB::Status status = enqueue ? Enqueue(db) : Dequeue(db);
+  return status == DB::kOK;
+}
+
+DB::Status QueueWorkload::Enqueue(DB &db) {
+  utils::Timer<uint64_t, std::nano> timer;
+  timer.Start();
+
+  const uint64_t seq = transaction_insert_key_sequence_->Next();
+  std::vector<DB::Field> values;
+  BuildMessage(seq, values);
+  DB::Status s = db.Insert(table_name_, QueueKey(seq), values);
+  transaction_insert_key_sequence_->Acknowledge(seq);
+
+  if (s == DB::kOK) {
+    depth_.fetch_add(1, std::memory_order_relaxed);
+    measurements_->Report(ENQUEUE, timer.End());
+  }
+  return s;
+}
+
+DB::Status QueueWorkload::Dequeue(DB &db) {
+  utils::Timer<uint64_t, std::nano> timer;
+  timer.Start();
+
+  const uint64_t from = seek_from_head_ ? head_.load(std::memory_order_relaxed) : first_seq_;
+  std::vector<std::vector<DB::Field>> result;
+  DB::Status s = db.Scan(table_name_, QueueKey(from), scan_length_, NULL, result);
+  if (s != DB::kOK) {
+    return s;
+  }
+
+  const std::string seq_field = field_prefix_ + "0";
+  const std::string time_field = field_prefix_ + "1";
+  for (auto &message : result) {
+    uint64_t seq = 0;
+    uint64_t enqueued = 0;
+    for (auto &field : message) {
+      if (field.name == seq_field) {
+        seq = std::stoull(field.value);
+      } else if (field.name == time_field) {
+        enqueued = std::stoull(field.value);
+      }
+    }
+
+    // messages are in enqueue order, so the rest are younger still
+    const uint64_t now = NowNanos();
+    if (now < enqueued + consumer_lag_) {
+      break;
+    }
+    if (!live_keys_->MarkDeleted(seq)) {
+      continue; // claimed by another consumer
+    }
+
+    s = db.Delete(table_name_, QueueKey(seq));
+    AdvanceHead();
+    if (s == DB::kOK) {
+      depth_.fetch_sub(1, std::memory_order_relaxed);
+      measurements_->Report(DEQUEUE, timer.End());
+      measurements_->Report(MESSAGE_AGE, now - enqueued);
+    }
+    return s;
+  }
+  // queue empty, too young, or every scanned message already claimed
+  return DB::kNotFound;
+}
+
+void QueueWorkload::AdvanceHead() {
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  while (head <= transaction_insert_key_sequence_->Last() && !live_keys_->IsLive(head)) {
+    if (head_.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
+      head++;
+    }
+  }
+}
+
+} // ycsbc
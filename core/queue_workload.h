@@ -0,0 +1,116 @@
+//
+//  queue_workload.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_QUEUE_WORKLOAD_H_
+#define YCSB_C_QUEUE_WORKLOAD_H_
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "core_workload.h"
+#include "db.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Persistent FIFO queue. Producers append messages under monotonically
+/// increasing keys; consumers scan from the head of the queue, claim the
+/// oldest unclaimed message and delete it. Deleted messages pile up as
+/// tombstones in front of the head, which is what makes this pattern hard on
+/// LSM iterators.
+///
+/// Each message carries its sequence number and enqueue time in the first two
+/// fields, so fieldcount must be at least 2. The load phase fills the queue
+/// with recordcount messages. Message keys start with keyprefix, "queue" by
+/// default.
+///
+class QueueWorkload : public CoreWorkload {
+ public:
+  ///
+  /// The name of the property for the proportion of enqueues, the rest of the
+  /// transactions are dequeues.
+  ///
+  static const std::string ENQUEUE_PROPORTION_PROPERTY;
+  static const std::string ENQUEUE_PROPORTION_DEFAULT;
+
+  ///
+  /// The name of the property for the maximum queue depth, unlimited if 0.
+  /// Producers dequeue instead of enqueueing while the queue is full.
+  ///
+  static const std::string MAX_DEPTH_PROPERTY;
+  static const std::string MAX_DEPTH_DEFAULT;
+
+  ///
+  /// The name of the property for how old a message must be before consumers
+  /// take it, in milliseconds.
+  ///
+  static const std::string CONSUMER_LAG_PROPERTY;
+  static const std::string CONSUMER_LAG_DEFAULT;
+
+  ///
+  /// The name of the property for where consumers start scanning. Options
+  /// are "start", which seeks to the first possible key and so crosses every
+  /// tombstone left by earlier dequeues, and "head", which seeks to the oldest
+  /// message the client knows to be unclaimed.
+  ///
+  static const std::string SEEK_FROM_PROPERTY;
+  static const std::string SEEK_FROM_DEFAULT;
+
+  ///
+  /// The name of the property for how many messages a consumer scans for an
+  /// unclaimed one.
+  ///
+  static const std::string SCAN_LENGTH_PROPERTY;
+  static const std::string SCAN_LENGTH_DEFAULT;
+
+  ///
+  /// The names of the properties for the sequence number of the oldest
+  /// unclaimed message, that of the next message to enqueue and the number
+  /// of messages in the queue, by default what the load phase left.
+  /// SaveState writes them so that a later invocation continues with the
+  /// queue as this one left it.
+  ///
+  static const std::string HEAD_PROPERTY;
+  static const std::string TAIL_PROPERTY;
+  static const std::string DEPTH_PROPERTY;
+
+  void Init(const utils::Properties &p) override;
+
+  bool DoInsert(DB &db) override;
+  bool DoTransaction(DB &db) override;
+  void SaveState(utils::Properties &state) override;
+  uint64_t GetLiveRecordCount() override { return std::max<int64_t>(depth_.load(), 0); }
+
+  QueueWorkload() : enqueue_proportion_(0), max_depth_(0), consumer_lag_(0), seek_from_head_(false),
+                    scan_length_(0), first_seq_(0), depth_(0), head_(0) {}
+
+ protected:
+  uint64_t TransactionInsertStart(const utils::Properties &p) override;
+
+ private:
+  std::string QueueKey(uint64_t seq);
+  void BuildMessage(uint64_t seq, std::vector<DB::Field> &values);
+  DB::Status Enqueue(DB &db);
+  DB::Status Dequeue(DB &db);
+  void AdvanceHead();
+
+  double enqueue_proportion_;
+  int64_t max_depth_;
+  uint64_t consumer_lag_;
+  bool seek_from_head_;
+  int scan_length_;
+  uint64_t first_seq_;
+  std::atomic<int64_t> depth_;
+  std::atomic<uint64_t> head_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_QUEUE_WORKLOAD_H_
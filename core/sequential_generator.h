@@ -0,0 +1,43 @@
+//
+//  sequential_generator.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_SEQUENTIAL_GENERATOR_H_
+#define YCSB_C_SEQUENTIAL_GENERATOR_H_
+
+#include "generator.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace ycsbc {
+
+///
+/// Walks the range in order and starts over at the end. Concurrent callers
+/// take turns through one atomic counter.
+///
+class SequentialGenerator : public Generator<uint64_t> {
+ public:
+  // Both min and max are inclusive
+  SequentialGenerator(uint64_t min, uint64_t max) : min_(min), items_(max - min + 1), counter_(0), last_(min) {}
+
+  uint64_t Next() {
+    const uint64_t value = min_ + counter_.fetch_add(1, std::memory_order_relaxed) % items_;
+    last_.store(value, std::memory_order_relaxed);
+    return value;
+  }
+  uint64_t Last() { return last_.load(std::memory_order_relaxed); }
+
+ private:
+  uint64_t min_;
+  uint64_t items_;
+  std::atomic<uint64_t> counter_;
+  std::atomic<uint64_t> last_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_SEQUENTIAL_GENERATOR_H_
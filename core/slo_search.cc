@@ -0,0 +1,209 @@
+//
+//  slo_search.cc
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#include "slo_search.h"
+#include "utils/affinity.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace ycsbc {
+
+namespace {
+
+// Sleeps for the given time, waking up early to return false if stop is raised.
+bool SleepUnlessStopped(std::chrono::seconds duration, const std::atomic<bool> *stop) {
+  const auto deadline = std::chrono::steady_clock::now() + duration;
+  while (!stop->load()) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(deadline - now,
+                                                                               std::chrono::milliseconds(100)));
+  }
+  return false;
+}
+
+} // namespace
+
+const std::string SloSearch::ENABLE_PROPERTY = "slo.search";
+const std::string SloSearch::ENABLE_DEFAULT = "false";
+
+const std::string SloSearch::OPERATION_PROPERTY = "slo.operation";
+const std::string SloSearch::OPERATION_DEFAULT = "READ";
+
+const std::string SloSearch::PERCENTILE_PROPERTY = "slo.percentile";
+const std::string SloSearch::PERCENTILE_DEFAULT = "99";
+
+const std::string SloSearch::LATENCY_PROPERTY = "slo.latency_us";
+
+const std::string SloSearch::WINDOW_PROPERTY = "slo.window";
+const std::string SloSearch::WINDOW_DEFAULT = "10";
+
+const std::string SloSearch::WARMUP_PROPERTY = "slo.warmup";
+const std::string SloSearch::WARMUP_DEFAULT = "2";
+
+const std::string SloSearch::START_RATE_PROPERTY = "slo.start_ops";
+const std::string SloSearch::START_RATE_DEFAULT = "1000";
+
+const std::string SloSearch::STEP_FACTOR_PROPERTY = "slo.step_factor";
+const std::string SloSearch::STEP_FACTOR_DEFAULT = "2";
+
+const std::string SloSearch::MAX_RATE_PROPERTY = "slo.max_ops";
+const std::string SloSearch::MAX_RATE_DEFAULT = "0";
+
+const std::string SloSearch::PRECISION_PROPERTY = "slo.precision";
+const std::string SloSearch::PRECISION_DEFAULT = "0.05";
+
+const std::string SloSearch::TOLERANCE_PROPERTY = "slo.tolerance";
+const std::string SloSearch::TOLERANCE_DEFAULT = "0.05";
+
+void SloSearch::Init(const utils::Properties &p) {
+  const std::string op_name = p.GetProperty(OPERATION_PROPERTY, OPERATION_DEFAULT);
+  auto it = std::find(std::begin(kOperationString), std::end(kOperationString), op_name);
+  if (it == std::end(kOperationString)) {
+    throw utils::Exception("Unknown operation for SLO search: " + op_name);
+  }
+  op_ = static_cast<Operation>(it - std::begin(kOperationString));
+
+  if (!p.ContainsKey(LATENCY_PROPERTY)) {
+    throw utils::Exception(LATENCY_PROPERTY + " is required by the SLO search");
+  }
+  latency_ns_ = std::stod(p.GetProperty(LATENCY_PROPERTY)) * 1000;
+  percentile_ = std::stod(p.GetProperty(PERCENTILE_PROPERTY, PERCENTILE_DEFAULT));
+  window_ = std::stoi(p.GetProperty(WINDOW_PROPERTY, WINDOW_DEFAULT));
+  warmup_ = std::stoi(p.GetProperty(WARMUP_PROPERTY, WARMUP_DEFAULT));
+  start_rate_ = std::stoll(p.GetProperty(START_RATE_PROPERTY, START_RATE_DEFAULT));
+  step_factor_ = std::stod(p.GetProperty(STEP_FACTOR_PROPERTY, STEP_FACTOR_DEFAULT));
+  max_rate_ = std::stoll(p.GetProperty(MAX_RATE_PROPERTY, MAX_RATE_DEFAULT));
+  precision_ = std::stod(p.GetProperty(PRECISION_PROPERTY, PRECISION_DEFAULT));
+  tolerance_ = std::stod(p.GetProperty(TOLERANCE_PROPERTY, TOLERANCE_DEFAULT));
+
+  if (window_ <= 0 || warmup_ < 0 || start_rate_ <= 0 || step_factor_ <= 1.0 || precision_ <= 0 ||
+      percentile_ <= 0 || percentile_ > 100) {
+    throw utils::Exception("Invalid SLO search parameters");
+  }
+  if (percentile_ < 100 && !HasPercentiles(p)) {
+    throw utils::Exception("SLO search on p" + p.GetProperty(PERCENTILE_PROPERTY, PERCENTILE_DEFAULT) +
+                           " needs measurements that keep percentiles, e.g. measurementtype=hdrhistogram");
+  }
+}
+
+bool SloSearch::Measure(int64_t rate, Measurements *interval, utils::RateLimiter *rlim,
+                        const std::atomic<bool> *stop, Point *point) {
+  rlim->SetRate(rate);
+  if (!SleepUnlessStopped(std::chrono::seconds(warmup_), stop)) {
+    return false;
+  }
+  interval->Reset();
+  // a window cut short by stop would count as a failed rate
+  if (!SleepUnlessStopped(std::chrono::seconds(window_), stop)) {
+    return false;
+  }
+
+  point->target = rate;
+  point->achieved = static_cast<double>(interval->GetClientOps()) / window_;
+  point->latency = interval->GetLatencyPercentile(op_, percentile_);
+  point->pass = interval->GetCount(op_) > 0 && point->latency <= latency_ns_ &&
+                point->achieved >= (1.0 - tolerance_) * rate;
+
+  std::cout << "SLO point: target(ops/sec)=" << point->target
+            << " achieved(ops/sec)=" << point->achieved
+            << " " << kOperationString[op_] << " p" << percentile_ << "(us)="
+            << point->latency / 1000.0
+            << (point->pass ? " pass" : " fail") << std::endl;
+  return true;
+}
+
+void SloSearch::Run(Measurements *measurements, utils::RateLimiter *rlim,
+                    std::atomic<bool> *stop, std::vector<int> cpus) {
+  try {
+    utils::SetThreadAffinity(cpus);
+    // measure each rate on its own, keeping the whole run for the final report
+    IntervalMeasurements *phase = dynamic_cast<IntervalMeasurements *>(measurements);
+    if (phase == nullptr) {
+      throw utils::Exception("SLO search needs interval measurements");
+    }
+    Measurements *interval = phase->OpenInterval();
+    Search(interval, rlim, stop);
+    phase->CloseInterval(interval);
+  } catch (const utils::Exception &e) {
+    std::cerr << "Caught exception: " << e.what() << std::endl;
+    exit(1);
+  }
+  stop->store(true);
+}
+
+void SloSearch::Search(Measurements *interval, utils::RateLimiter *rlim,
+                       const std::atomic<bool> *stop) {
+  std::vector<Point> curve;
+  Point point;
+  bool interrupted = false;
+
+  // step up until the target is missed
+  int64_t lo = 0;
+  int64_t hi = 0;
+  int64_t rate = start_rate_;
+  while (true) {
+    if (max_rate_ > 0 && rate >= max_rate_) {
+      rate = max_rate_;
+    }
+    if (!Measure(rate, interval, rlim, stop, &point)) {
+      interrupted = true;
+      break;
+    }
+    curve.push_back(point);
+    if (!curve.back().pass) {
+      hi = rate;
+      break;
+    }
+    lo = rate;
+    if (rate == max_rate_) {
+      break;
+    }
+    // at least one more op/sec, or small rates would never grow
+    rate = std::max(rate + 1, static_cast<int64_t>(rate * step_factor_));
+  }
+
+  // binary search between the last passing and the first failing rate
+  while (!interrupted && hi > 0 && hi - lo > precision_ * hi && hi - lo > 1) {
+    rate = lo + (hi - lo) / 2;
+    if (!Measure(rate, interval, rlim, stop, &point)) {
+      interrupted = true;
+      break;
+    }
+    curve.push_back(point);
+    if (curve.back().pass) {
+      lo = rate;
+    } else {
+      hi = rate;
+    }
+  }
+
+  std::sort(curve.begin(), curve.end(), [](const Point &a, const Point &b) {
+    return a.target < b.target;
+  });
+  std::cout << "SLO target: " << kOperationString[op_] << " p" << percentile_
+            << " <= " << latency_ns_ / 1000.0 << " us" << std::endl;
+  std::cout << "SLO curve: target(ops/sec) achieved(ops/sec) latency(us) result" << std::endl;
+  for (const Point &point : curve) {
+    std::cout << "  " << point.target << ' ' << point.achieved << ' '
+              << point.latency / 1000.0 << (point.pass ? " pass" : " fail") << std::endl;
+  }
+  if (interrupted) {
+    std::cout << "SLO max sustainable throughput(ops/sec): unknown, the run stopped before the search ended"
+              << std::endl;
+  } else {
+    std::cout << "SLO max sustainable throughput(ops/sec): " << lo << std::endl;
+  }
+}
+
+} // ycsbc
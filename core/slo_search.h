@@ -0,0 +1,136 @@
+//
+//  slo_search.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_SLO_SEARCH_H_
+#define YCSB_C_SLO_SEARCH_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "core_workload.h"
+#include "measurements.h"
+#include "utils/properties.h"
+#include "utils/rate_limit.h"
+
+namespace ycsbc {
+
+///
+/// Searches for the highest throughput at which a latency percentile of one
+/// operation stays within a target, by driving the client rate limiters
+/// through a step-up phase followed by a binary search.
+///
+class SloSearch {
+ public:
+  ///
+  /// The name of the property for enabling the search during the
+  /// transaction phase.
+  ///
+  static const std::string ENABLE_PROPERTY;
+  static const std::string ENABLE_DEFAULT;
+
+  ///
+  /// The name of the property for the operation whose latency is bounded.
+  ///
+  static const std::string OPERATION_PROPERTY;
+  static const std::string OPERATION_DEFAULT;
+
+  ///
+  /// The name of the property for the bounded percentile.
+  ///
+  static const std::string PERCENTILE_PROPERTY;
+  static const std::string PERCENTILE_DEFAULT;
+
+  ///
+  /// The name of the property for the latency target in microseconds.
+  ///
+  static const std::string LATENCY_PROPERTY;
+
+  ///
+  /// The name of the property for how long each rate is measured, in seconds.
+  ///
+  static const std::string WINDOW_PROPERTY;
+  static const std::string WINDOW_DEFAULT;
+
+  ///
+  /// The name of the property for how long each rate runs before it is
+  /// measured, in seconds.
+  ///
+  static const std::string WARMUP_PROPERTY;
+  static const std::string WARMUP_DEFAULT;
+
+  ///
+  /// The name of the property for the first rate of the step-up phase.
+  ///
+  static const std::string START_RATE_PROPERTY;
+  static const std::string START_RATE_DEFAULT;
+
+  ///
+  /// The name of the property for the rate multiplier of the step-up phase.
+  ///
+  static const std::string STEP_FACTOR_PROPERTY;
+  static const std::string STEP_FACTOR_DEFAULT;
+
+  ///
+  /// The name of the property for the highest rate to try, unlimited if <= 0.
+  ///
+  static const std::string MAX_RATE_PROPERTY;
+  static const std::string MAX_RATE_DEFAULT;
+
+  ///
+  /// The name of the property for the relative width of the rate range at
+  /// which the binary search stops.
+  ///
+  static const std::string PRECISION_PROPERTY;
+  static const std::string PRECISION_DEFAULT;
+
+  ///
+  /// The name of the property for how far the achieved throughput may fall
+  /// short of the target rate before the rate counts as unsustainable.
+  ///
+  static const std::string TOLERANCE_PROPERTY;
+  static const std::string TOLERANCE_DEFAULT;
+
+  void Init(const utils::Properties &p);
+
+  int64_t start_rate() const { return start_rate_; }
+
+  ///
+  /// Runs the search, then raises stop so that client threads finish. If
+  /// stop is raised first, e.g. by maxexecutiontime, the search ends early
+  /// and reports no result.
+  ///
+  void Run(Measurements *measurements, utils::RateLimiter *rlim,
+           std::atomic<bool> *stop, std::vector<int> cpus);
+
+ private:
+  struct Point {
+    int64_t target;
+    double achieved;
+    uint64_t latency;
+    bool pass;
+  };
+
+  void Search(Measurements *interval, utils::RateLimiter *rlim, const std::atomic<bool> *stop);
+  bool Measure(int64_t rate, Measurements *interval, utils::RateLimiter *rlim,
+               const std::atomic<bool> *stop, Point *point);
+
+  Operation op_;
+  double percentile_;
+  uint64_t latency_ns_;
+  int window_;
+  int warmup_;
+  int64_t start_rate_;
+  double step_factor_;
+  int64_t max_rate_;
+  double precision_;
+  double tolerance_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_SLO_SEARCH_H_
@@ -0,0 +1,100 @@
+//
+//  space_report.cc
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#include "space_report.h"
+#include "db_wrapper.h"
+#include "utils/files.h"
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace ycsbc {
+
+const std::string SpaceReport::RECORD_BYTES_PROPERTY = "space.recordbytes";
+
+namespace {
+
+const double kMB = 1024.0 * 1024.0;
+
+} // namespace
+
+bool SpaceReport::ReadProcIo(uint64_t *read_bytes, uint64_t *write_bytes) {
+  std::ifstream input("/proc/self/io");
+  std::string name;
+  uint64_t value;
+  int found = 0;
+  while (input >> name >> value) {
+    if (name == "read_bytes:") {
+      *read_bytes = value;
+      found++;
+    } else if (name == "write_bytes:") {
+      *write_bytes = value;
+      found++;
+    }
+  }
+  return found == 2;
+}
+
+void SpaceReport::Start() {
+  bytes_written_ = DBWrapper::BytesWritten();
+  if (!ReadProcIo(&read_bytes_, &write_bytes_)) {
+    read_bytes_ = write_bytes_ = 0;
+  }
+}
+
+double SpaceReport::RecordBytes(const utils::Properties &props) {
+  if (DBWrapper::RecordsInserted() > 0) {
+    return static_cast<double>(DBWrapper::BytesInserted()) / DBWrapper::RecordsInserted();
+  }
+  return std::stod(props.GetProperty(RECORD_BYTES_PROPERTY, "0"));
+}
+
+void SpaceReport::Print(const std::string &phase, DB *db, uint64_t record_count,
+                        const utils::Properties &props) {
+  // allocated blocks rather than file sizes, since LMDB and others map sparse files
+  const std::vector<std::string> paths = db->GetDataPaths();
+  uint64_t disk_size = 0;
+  for (const std::string &path : paths) {
+    utils::WalkFiles(path, [&disk_size](const std::string &, const struct stat &st) {
+      disk_size += static_cast<uint64_t>(st.st_blocks) * 512;
+    });
+  }
+  const uint64_t logical = DBWrapper::BytesWritten() - bytes_written_;
+  uint64_t read_bytes = 0;
+  uint64_t write_bytes = 0;
+  const bool has_io = ReadProcIo(&read_bytes, &write_bytes);
+  read_bytes -= read_bytes_;
+  write_bytes -= write_bytes_;
+  const double live = record_count * RecordBytes(props);
+
+  if (paths.empty()) {
+    std::cout << phase << " disk size(MB): unknown" << std::endl;
+  } else {
+    std::cout << phase << " disk size(MB): " << disk_size / kMB << std::endl;
+  }
+  std::cout << phase << " logical bytes written(MB): " << logical / kMB << std::endl;
+  if (has_io) {
+    std::cout << phase << " disk bytes read(MB): " << read_bytes / kMB << std::endl;
+    std::cout << phase << " disk bytes written(MB): " << write_bytes / kMB << std::endl;
+  } else {
+    std::cout << phase << " disk bytes read(MB): unknown" << std::endl;
+    std::cout << phase << " disk bytes written(MB): unknown" << std::endl;
+  }
+  if (has_io && logical > 0) {
+    std::cout << phase << " write amplification: " << static_cast<double>(write_bytes) / logical << std::endl;
+  } else {
+    std::cout << phase << " write amplification: unknown" << std::endl;
+  }
+  if (!paths.empty() && live > 0) {
+    std::cout << phase << " space amplification: " << disk_size / live << std::endl;
+  } else {
+    std::cout << phase << " space amplification: unknown" << std::endl;
+  }
+}
+
+} // ycsbc
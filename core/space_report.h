@@ -0,0 +1,75 @@
+//
+//  space_report.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_SPACE_REPORT_H_
+#define YCSB_C_SPACE_REPORT_H_
+
+#include <string>
+
+#include "db.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Reports, at the end of a phase, what the database takes on disk and what
+/// it wrote, next to what the clients wrote:
+///
+/// - disk size: blocks allocated to the files of DB::GetDataPaths
+/// - logical bytes written: keys and values of successful writes, as summed
+///   by DBWrapper
+/// - disk bytes read and written: read_bytes and write_bytes of
+///   /proc/self/io, which include the engine's background threads
+///
+/// Write amplification is disk bytes written over logical bytes written in
+/// the phase. Space amplification is disk size over the logical size of the
+/// records the database holds, i.e. the record count times the average
+/// logical size of an inserted record. Deletes are not subtracted.
+///
+class SpaceReport {
+ public:
+  ///
+  /// The name of the property for the average logical size of a record,
+  /// saved with the workload state so that later invocations that insert
+  /// nothing can still tell the space amplification.
+  ///
+  static const std::string RECORD_BYTES_PROPERTY;
+
+  ///
+  /// Marks the start of a phase.
+  ///
+  void Start();
+
+  ///
+  /// Prints the report of the phase since Start, each line prefixed by phase.
+  /// record_count is the number of records the database holds.
+  ///
+  void Print(const std::string &phase, DB *db, uint64_t record_count, const utils::Properties &props);
+
+  ///
+  /// Average logical size of a record inserted by this process, or else the
+  /// one saved in props. 0 if neither is known.
+  ///
+  static double RecordBytes(const utils::Properties &props);
+
+  SpaceReport() : bytes_written_(0), read_bytes_(0), write_bytes_(0) {}
+
+ private:
+  ///
+  /// Reads read_bytes and write_bytes of /proc/self/io. Returns false if the
+  /// kernel does not provide them.
+  ///
+  static bool ReadProcIo(uint64_t *read_bytes, uint64_t *write_bytes);
+
+  uint64_t bytes_written_;
+  uint64_t read_bytes_;
+  uint64_t write_bytes_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_SPACE_REPORT_H_
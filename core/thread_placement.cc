@@ -0,0 +1,95 @@
+//
+//  thread_placement.cc
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#include "thread_placement.h"
+#include "utils/affinity.h"
+#include "utils/utils.h"
+
+#include <set>
+
+namespace ycsbc {
+
+const std::string ThreadPlacement::POLICY_PROPERTY = "affinity.policy";
+const std::string ThreadPlacement::POLICY_DEFAULT = "none";
+
+const std::string ThreadPlacement::CPUS_PROPERTY = "affinity.cpus";
+
+const std::string ThreadPlacement::NUMA_NODES_PROPERTY = "affinity.numa_nodes";
+
+const std::string ThreadPlacement::AUX_CPUS_PROPERTY = "affinity.aux_cpus";
+
+void ThreadPlacement::Init(const utils::Properties &p, int num_threads) {
+  client_cpus_.clear();
+  aux_cpus_.clear();
+
+  const std::string policy = p.GetProperty(POLICY_PROPERTY, POLICY_DEFAULT);
+  if (policy == "none") {
+    // nothing to pin
+  } else if (policy == "cpus") {
+    std::vector<int> cpus = utils::ParseCpuList(p.GetProperty(CPUS_PROPERTY));
+    if (cpus.empty()) {
+      throw utils::Exception(CPUS_PROPERTY + " is required by the cpus policy");
+    }
+    for (int i = 0; i < num_threads; i++) {
+      client_cpus_.push_back({cpus[i % cpus.size()]});
+    }
+  } else if (policy == "numa") {
+    std::vector<int> nodes;
+    if (p.ContainsKey(NUMA_NODES_PROPERTY)) {
+      nodes = utils::ParseCpuList(p.GetProperty(NUMA_NODES_PROPERTY));
+    } else {
+      nodes = utils::NumaNodesWithCpus();
+    }
+    if (nodes.empty()) {
+      throw utils::Exception("no NUMA nodes found for the numa policy");
+    }
+    std::vector<std::vector<int>> node_cpus;
+    for (int node : nodes) {
+      node_cpus.push_back(utils::NumaNodeCpus(node));
+      if (node_cpus.back().empty()) {
+        throw utils::Exception("no cpus found for NUMA node " + std::to_string(node));
+      }
+    }
+    for (int i = 0; i < num_threads; i++) {
+      client_cpus_.push_back(node_cpus[i % node_cpus.size()]);
+    }
+  } else {
+    throw utils::Exception("Unknown affinity policy: " + policy);
+  }
+
+  if (p.ContainsKey(AUX_CPUS_PROPERTY)) {
+    aux_cpus_ = utils::ParseCpuList(p.GetProperty(AUX_CPUS_PROPERTY));
+  } else if (!client_cpus_.empty()) {
+    std::set<int> used;
+    for (const std::vector<int> &cpus : client_cpus_) {
+      used.insert(cpus.begin(), cpus.end());
+    }
+    for (int cpu : utils::OnlineCpus()) {
+      if (used.count(cpu) == 0) {
+        aux_cpus_.push_back(cpu);
+      }
+    }
+  }
+}
+
+std::vector<int> ThreadPlacement::ClientCpus(int thread_id) const {
+  if (client_cpus_.empty()) {
+    return std::vector<int>();
+  }
+  return client_cpus_[thread_id % client_cpus_.size()];
+}
+
+ThreadPlacement ThreadPlacement::Offset(int first_thread) const {
+  ThreadPlacement placement;
+  placement.aux_cpus_ = aux_cpus_;
+  for (size_t i = 0; i < client_cpus_.size(); i++) {
+    placement.client_cpus_.push_back(client_cpus_[(first_thread + i) % client_cpus_.size()]);
+  }
+  return placement;
+}
+
+} // ycsbc
@@ -0,0 +1,74 @@
+//
+//  thread_placement.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_THREAD_PLACEMENT_H_
+#define YCSB_C_THREAD_PLACEMENT_H_
+
+#include <string>
+#include <vector>
+
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Decides which cpus client threads and auxiliary (status, rate limit)
+/// threads run on.
+///
+class ThreadPlacement {
+ public:
+  ///
+  /// Placement policy. Options are "none" (threads float freely),
+  /// "cpus" (client thread i is pinned to the i-th cpu of affinity.cpus)
+  /// and "numa" (client threads are spread round robin over NUMA nodes and
+  /// may run on any cpu of their node).
+  ///
+  static const std::string POLICY_PROPERTY;
+  static const std::string POLICY_DEFAULT;
+
+  ///
+  /// Cpu list used by the "cpus" policy, e.g. "0-7,16-23".
+  ///
+  static const std::string CPUS_PROPERTY;
+
+  ///
+  /// Node list used by the "numa" policy. Defaults to every node with cpus.
+  ///
+  static const std::string NUMA_NODES_PROPERTY;
+
+  ///
+  /// Cpu list for auxiliary threads. Defaults to the online cpus that are
+  /// not used by client threads, or no pinning if there are none left.
+  ///
+  static const std::string AUX_CPUS_PROPERTY;
+
+  void Init(const utils::Properties &p, int num_threads);
+
+  ///
+  /// Cpus for the given client thread, empty if it is not pinned.
+  ///
+  std::vector<int> ClientCpus(int thread_id) const;
+
+  ///
+  /// Cpus for auxiliary threads, empty if they are not pinned.
+  ///
+  std::vector<int> AuxCpus() const { return aux_cpus_; }
+
+  ///
+  /// Placement in which client thread i gets the cpus of client thread
+  /// first_thread + i, for thread groups that run side by side.
+  ///
+  ThreadPlacement Offset(int first_thread) const;
+
+ private:
+  std::vector<std::vector<int>> client_cpus_;
+  std::vector<int> aux_cpus_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_THREAD_PLACEMENT_H_
@@ -0,0 +1,261 @@
+//
+//  timeseries_workload.cc
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#include "timeseries_workload.h"
+#include "measurements.h"
+#include "uniform_generator.h"
+#include "zipfian_generator.h"
+#include "utils/timer.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace ycsbc {
+
+const std::string TimeSeriesWorkload::SERIES_PROPERTY = "timeseries.series";
+const std::string TimeSeriesWorkload::SERIES_DEFAULT = "1000";
+
+const std::string TimeSeriesWorkload::BATCH_SIZE_PROPERTY = "timeseries.batchsize";
+const std::string TimeSeriesWorkload::BATCH_SIZE_DEFAULT = "10";
+
+const std::string TimeSeriesWorkload::INTERVAL_PROPERTY = "timeseries.interval_ms";
+const std::string TimeSeriesWorkload::INTERVAL_DEFAULT = "1000";
+
+const std::string TimeSeriesWorkload::QUERY_WINDOW_PROPERTY = "timeseries.querywindow_ms";
+const std::string TimeSeriesWorkload::QUERY_WINDOW_DEFAULT = "3600000";
+
+const std::string TimeSeriesWorkload::QUERY_START_PROPERTY = "timeseries.querystart";
+const std::string TimeSeriesWorkload::QUERY_START_DEFAULT = "recent";
+
+const std::string TimeSeriesWorkload::BUCKET_PROPERTY = "timeseries.bucket_ms";
+const std::string TimeSeriesWorkload::BUCKET_DEFAULT = "60000";
+
+const std::string TimeSeriesWorkload::QUERY_PROPORTION_PROPERTY = "timeseries.queryproportion";
+const std::string TimeSeriesWorkload::QUERY_PROPORTION_DEFAULT = "0.1";
+
+const std::string TimeSeriesWorkload::NEXT_POINTS_PROPERTY = "timeseries.nextpoints";
+
+void TimeSeriesWorkload::Init(const utils::Properties &p) {
+  CoreWorkload::Init(p);
+  if (data_integrity_) {
+    throw utils::Exception(DATA_INTEGRITY_PROPERTY + " is not supported by the timeseries workload");
+  }
+
+  if (field_count_ < 3) {
+    throw utils::Exception("timeseries workload needs fieldcount >= 3");
+  }
+  series_ = std::stoull(p.GetProperty(SERIES_PROPERTY, SERIES_DEFAULT));
+  batch_size_ = std::stoi(p.GetProperty(BATCH_SIZE_PROPERTY, BATCH_SIZE_DEFAULT));
+  interval_ = std::stoull(p.GetProperty(INTERVAL_PROPERTY, INTERVAL_DEFAULT));
+  uint64_t window = std::stoull(p.GetProperty(QUERY_WINDOW_PROPERTY, QUERY_WINDOW_DEFAULT));
+  bucket_ = std::stoull(p.GetProperty(BUCKET_PROPERTY, BUCKET_DEFAULT));
+  query_proportion_ = std::stod(p.GetProperty(QUERY_PROPORTION_PROPERTY, QUERY_PROPORTION_DEFAULT));
+  if (series_ == 0 || batch_size_ <= 0 || interval_ == 0 || window < interval_ || bucket_ == 0) {
+    throw utils::Exception("Invalid timeseries parameters");
+  }
+  window_points_ = window / interval_;
+
+  const std::string query_start = p.GetProperty(QUERY_START_PROPERTY, QUERY_START_DEFAULT);
+  if (query_start == "recent") {
+    query_recent_ = true;
+  } else if (query_start == "uniform") {
+    query_recent_ = false;
+  } else {
+    throw utils::Exception("Unknown " + QUERY_START_PROPERTY + ": " + query_start);
+  }
+
+  const std::string request_dist = p.GetProperty(REQUEST_DISTRIBUTION_PROPERTY, REQUEST_DISTRIBUTION_DEFAULT);
+  if (request_dist == "uniform") {
+    series_chooser_ = new UniformGenerator(0, series_ - 1);
+  } else if (request_dist == "zipfian") {
+    series_chooser_ = new ZipfianGenerator(0, series_ - 1);
+  } else {
+    throw utils::Exception("Distribution not allowed for timeseries: " + request_dist);
+  }
+
+  // the load phase spreads recordcount points round robin over the series
+  next_point_.reset(new std::atomic<uint64_t>[series_]);
+  for (uint64_t s = 0; s < series_; s++) {
+    next_point_[s] = record_count_ / series_ + (s < record_count_ % series_ ? 1 : 0);
+  }
+  if (p.ContainsKey(NEXT_POINTS_PROPERTY)) {
+    std::stringstream ss(p.GetProperty(NEXT_POINTS_PROPERTY));
+    std::string item;
+    uint64_t s = 0;
+    for (; std::getline(ss, item, ','); s++) {
+      if (s >= series_) {
+        break;
+      }
+      next_point_[s] = std::stoull(item);
+    }
+    if (s != series_) {
+      throw utils::Exception(NEXT_POINTS_PROPERTY + " does not match " + SERIES_PROPERTY);
+    }
+  }
+}
+
+void TimeSeriesWorkload::SaveState(utils::Properties &state) {
+  CoreWorkload::SaveState(state);
+  std::string next_points;
+  for (uint64_t s = 0; s < series_; s++) {
+    next_points.append(s > 0 ? "," : "").append(std::to_string(next_point_[s].load()));
+  }
+  state.SetProperty(NEXT_POINTS_PROPERTY, next_points);
+}
+
+uint64_t TimeSeriesWorkload::GetLiveRecordCount() {
+  uint64_t points = 0;
+  for (uint64_t s = 0; s < series_; s++) {
+    points += next_point_[s].load();
+  }
+  return points;
+}
+
+std::string TimeSeriesWorkload::PointKey(uint64_t series, uint64_t index) {
+  // the points of a series share its key and a separator that sorts after
+  // any digit, then a fixed-width time, so that key order is time order
+  std::string t = std::to_string(index * interval_);
+  return BuildKeyName(series).append(":").append(20 - std::min<size_t>(20, t.size()), '0').append(t);
+}
+
+bool TimeSeriesWorkload::DoInsert(DB &db) {
+  const uint64_t n = insert_key_sequence_->Next();
+  const uint64_t series = n % series_;
+  const uint64_t index = n / series_;
+  std::vector<DB::Field> values;
+  BuildValues(values);
+  values[0].value = std::to_string(series);
+  values[1].value = std::to_string(index * interval_);
+  values[2].value = std::to_string(utils::ThreadLocalRandomDouble(0, 100));
+  return db.Insert(table_name_, PointKey(series, index), values) == DB::kOK;
+}
+
+bool TimeSeriesWorkload::DoTransaction(DB &db) {
+  DB::Status status;
+  if (utils::ThreadLocalRandomDouble() < query_proportion_) {
+    status = QueryWindow(db);
+  } else {
+    status = AppendPoints(db);
+  }
+  return status == DB::kOK;
+}
+
+DB::Status TimeSeriesWorkload::AppendPoints(DB &db) {
+  utils::Timer<uint64_t, std::nano> timer;
+  timer.Start();
+
+  const uint64_t series = series_chooser_->Next();
+  const uint64_t first = next_point_[series].fetch_add(batch_size_);
+  std::vector<DB::Mutation> batch(batch_size_);
+  for (int i = 0; i < batch_size_; i++) {
+    DB::Mutation &m = batch[i];
+    m.type = DB::Mutation::kInsert;
+    m.key = PointKey(series, first + i);
+    BuildValues(m.values);
+    m.values[0].value = std::to_string(series);
+    m.values[1].value = std::to_string((first + i) * interval_);
+    m.values[2].value = std::to_string(utils::ThreadLocalRandomDouble(0, 100));
+  }
+  DB::Status s = db.BatchWrite(table_name_, batch);
+
+  if (s == DB::kOK) {
+    measurements_->Report(APPEND_POINTS, timer.End());
+  }
+  return s;
+}
+
+DB::Status TimeSeriesWorkload::QueryWindow(DB &db) {
+  utils::Timer<uint64_t, std::nano> timer;
+  timer.Start();
+
+  const uint64_t series = series_chooser_->Next();
+  const uint64_t written = next_point_[series].load();
+  const uint64_t last_start = written > static_cast<uint64_t>(window_points_) ? written - window_points_ : 0;
+  const uint64_t start = query_recent_ ? last_start
+                         : static_cast<uint64_t>(utils::ThreadLocalRandomDouble(0, last_start + 1));
+
+  std::vector<std::vector<DB::Field>> result;
+  DB::Status s = db.Scan(table_name_, PointKey(series, start), window_points_, NULL, result);
+  if (s != DB::kOK) {
+    return s;
+  }
+
+  // downsample into buckets of min, max and mean
+  struct Bucket {
+    double min;
+    double max;
+    double sum;
+    int count;
+  };
+  std::map<uint64_t, Bucket> buckets;
+  uint64_t points = 0;
+  const std::string series_field = field_prefix_ + "0";
+  const std::string time_field = field_prefix_ + "1";
+  const std::string value_field = field_prefix_ + "2";
+  const std::string series_value = std::to_string(series);
+  for (auto &point : result) {
+    bool in_series = false;
+    uint64_t time = 0;
+    double value = 0;
+    for (auto &field : point) {
+      if (field.name == series_field) {
+        in_series = (field.value == series_value);
+      } else if (field.name == time_field) {
+        time = std::stoull(field.value);
+      } else if (field.name == value_field) {
+        value = std::stod(field.value);
+      }
+    }
+    if (!in_series) {
+      break; // ran past the end of the series
+    }
+    points++;
+    auto it = buckets.find(time / bucket_);
+    if (it == buckets.end()) {
+      buckets[time / bucket_] = Bucket{value, value, value, 1};
+    } else {
+      it->second.min = std::min(it->second.min, value);
+      it->second.max = std::max(it->second.max, value);
+      it->second.sum += value;
+      it->second.count++;
+    }
+  }
+
+  // the downsampled series is what the client gets back
+  double mean_sum = 0;
+  for (const auto &bucket : buckets) {
+    mean_sum += bucket.second.sum / bucket.second.count;
+  }
+  measurements_->Report(QUERY_WINDOW, timer.End());
+
+  queries_.fetch_add(1, std::memory_order_relaxed);
+  query_points_.fetch_add(points, std::memory_order_relaxed);
+  query_buckets_.fetch_add(buckets.size(), std::memory_order_relaxed);
+  query_mean_sum_.fetch_add(std::llround(mean_sum * 1000), std::memory_order_relaxed);
+  return s;
+}
+
+void TimeSeriesWorkload::FinishRun(DB &db) {
+  const uint64_t queries = queries_.exchange(0);
+  const uint64_t points = query_points_.exchange(0);
+  const uint64_t buckets = query_buckets_.exchange(0);
+  const uint64_t mean_sum = query_mean_sum_.exchange(0);
+  if (queries == 0) {
+    return;
+  }
+  std::cout << "Window queries: queries=" << queries
+            << " points per query=" << static_cast<double>(points) / queries
+            << " buckets per query=" << static_cast<double>(buckets) / queries
+            << " bucket mean=" << (buckets > 0 ? mean_sum / 1000.0 / buckets : 0) << std::endl;
+}
+
+} // ycsbc
@@ -0,0 +1,132 @@
+//
+//  timeseries_workload.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_TIMESERIES_WORKLOAD_H_
+#define YCSB_C_TIMESERIES_WORKLOAD_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core_workload.h"
+#include "db.h"
+#include "generator.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Time-series ingestion and query workload. Each series appends points
+/// under keys made of the series id and a timestamp, so the points of one
+/// series are contiguous and in time order. Writes append a batch of points
+/// to one series; queries range-scan a time window of one series and
+/// downsample it into fixed-width buckets on the client.
+///
+/// Timestamps are logical: point i of a series is at i * interval_ms. Keys
+/// are the key of the series number, as keyprefix and insertorder make it,
+/// followed by the timestamp. The load phase spreads recordcount points
+/// round robin over the series. The
+/// first three fields of a point hold its series, timestamp and value, so
+/// fieldcount must be at least 3. requestdistribution ("uniform" or
+/// "zipfian") picks the series.
+///
+class TimeSeriesWorkload : public CoreWorkload {
+ public:
+  ///
+  /// The name of the property for the number of series.
+  ///
+  static const std::string SERIES_PROPERTY;
+  static const std::string SERIES_DEFAULT;
+
+  ///
+  /// The name of the property for the number of points per write.
+  ///
+  static const std::string BATCH_SIZE_PROPERTY;
+  static const std::string BATCH_SIZE_DEFAULT;
+
+  ///
+  /// The name of the property for the time between points of a series,
+  /// in milliseconds.
+  ///
+  static const std::string INTERVAL_PROPERTY;
+  static const std::string INTERVAL_DEFAULT;
+
+  ///
+  /// The name of the property for the length of a query window, in
+  /// milliseconds.
+  ///
+  static const std::string QUERY_WINDOW_PROPERTY;
+  static const std::string QUERY_WINDOW_DEFAULT;
+
+  ///
+  /// The name of the property for where query windows fall. Options are
+  /// "recent", the latest window of the series, and "uniform", anywhere in
+  /// its history.
+  ///
+  static const std::string QUERY_START_PROPERTY;
+  static const std::string QUERY_START_DEFAULT;
+
+  ///
+  /// The name of the property for the width of a downsampling bucket, in
+  /// milliseconds.
+  ///
+  static const std::string BUCKET_PROPERTY;
+  static const std::string BUCKET_DEFAULT;
+
+  ///
+  /// The name of the property for the proportion of queries, the rest of the
+  /// transactions are writes.
+  ///
+  static const std::string QUERY_PROPORTION_PROPERTY;
+  static const std::string QUERY_PROPORTION_DEFAULT;
+
+  ///
+  /// The name of the property for the number of points of each series, as a
+  /// comma-separated list, by default what the load phase left. SaveState
+  /// writes it so that a later invocation appends after the points written.
+  ///
+  static const std::string NEXT_POINTS_PROPERTY;
+
+  void Init(const utils::Properties &p) override;
+
+  bool DoInsert(DB &db) override;
+  bool DoTransaction(DB &db) override;
+  void FinishRun(DB &db) override;
+  void SaveState(utils::Properties &state) override;
+  uint64_t GetLiveRecordCount() override;
+
+  TimeSeriesWorkload() : series_(0), batch_size_(0), interval_(0), window_points_(0), query_recent_(true),
+                         bucket_(0), query_proportion_(0), series_chooser_(nullptr), queries_(0),
+                         query_points_(0), query_buckets_(0), query_mean_sum_(0) {}
+  ~TimeSeriesWorkload() override { delete series_chooser_; }
+
+ private:
+  std::string PointKey(uint64_t series, uint64_t index);
+  DB::Status AppendPoints(DB &db);
+  DB::Status QueryWindow(DB &db);
+
+  uint64_t series_;
+  int batch_size_;
+  uint64_t interval_;
+  int window_points_;
+  bool query_recent_;
+  uint64_t bucket_;
+  double query_proportion_;
+  Generator<uint64_t> *series_chooser_;
+  // number of points claimed per series, including those still being written
+  std::unique_ptr<std::atomic<uint64_t>[]> next_point_;
+  // what the queries returned, in thousandths for the bucket means
+  std::atomic<uint64_t> queries_;
+  std::atomic<uint64_t> query_points_;
+  std::atomic<uint64_t> query_buckets_;
+  std::atomic<uint64_t> query_mean_sum_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_TIMESERIES_WORKLOAD_H_
@@ -0,0 +1,117 @@
+//
+//  warmup_curve.cc
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#include "warmup_curve.h"
+#include "utils/affinity.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace ycsbc {
+
+const std::string WarmupCurve::COLD_START_PROPERTY = "coldstart";
+const std::string WarmupCurve::COLD_START_DEFAULT = "false";
+
+const std::string WarmupCurve::EVICT_INTERVAL_PROPERTY = "coldstart.evictinterval";
+const std::string WarmupCurve::EVICT_INTERVAL_DEFAULT = "0";
+
+const std::string WarmupCurve::INTERVAL_PROPERTY = "warmup.interval";
+const std::string WarmupCurve::INTERVAL_DEFAULT = "1";
+
+const std::string WarmupCurve::TOLERANCE_PROPERTY = "warmup.tolerance";
+const std::string WarmupCurve::TOLERANCE_DEFAULT = "0.1";
+
+void WarmupCurve::Init(const utils::Properties &p) {
+  enabled_ = utils::StrToBool(p.GetProperty(COLD_START_PROPERTY, COLD_START_DEFAULT));
+  evict_interval_ = std::stoi(p.GetProperty(EVICT_INTERVAL_PROPERTY, EVICT_INTERVAL_DEFAULT));
+  interval_ = std::stoi(p.GetProperty(INTERVAL_PROPERTY, INTERVAL_DEFAULT));
+  tolerance_ = std::stod(p.GetProperty(TOLERANCE_PROPERTY, TOLERANCE_DEFAULT));
+  if (evict_interval_ < 0 || interval_ <= 0 || tolerance_ < 0 || tolerance_ >= 1) {
+    throw utils::Exception("Invalid warm-up parameters");
+  }
+}
+
+void WarmupCurve::Start(Measurements *measurements, std::function<void()> evict, std::vector<int> cpus) {
+  measurements_ = dynamic_cast<IntervalMeasurements *>(measurements);
+  if (!enabled_ || measurements_ == nullptr) {
+    return;
+  }
+  points_.clear();
+  stop_ = false;
+  current_ = measurements_->OpenInterval();
+  thread_ = std::thread(&WarmupCurve::Sample, this, evict, cpus);
+}
+
+void WarmupCurve::Stop() {
+  if (!thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+  measurements_->CloseInterval(current_);
+
+  if (points_.empty()) {
+    std::cout << "Warm-up curve: run shorter than " << interval_ << " sec" << std::endl;
+    return;
+  }
+  for (const Point &point : points_) {
+    std::cout << "Warm-up " << point.time << " sec: throughput(ops/sec)=" << point.throughput
+              << " latency(us):" << point.latency << std::endl;
+  }
+
+  const size_t tail = std::max<size_t>(1, points_.size() / 4);
+  double steady = 0;
+  for (size_t i = points_.size() - tail; i < points_.size(); i++) {
+    steady += points_[i].throughput;
+  }
+  steady /= tail;
+  // the warm-up ends once throughput stops falling below the steady state
+  size_t warm = points_.size();
+  while (warm > 0 && points_[warm - 1].throughput >= (1 - tolerance_) * steady) {
+    warm--;
+  }
+  std::cout << "Warm-up steady throughput(ops/sec): " << steady << std::endl;
+  if (warm == points_.size()) {
+    std::cout << "Warm-up time(sec): not reached" << std::endl;
+  } else {
+    std::cout << "Warm-up time(sec): " << (warm == 0 ? 0 : points_[warm - 1].time) << std::endl;
+  }
+}
+
+void WarmupCurve::Sample(std::function<void()> evict, std::vector<int> cpus) {
+  utils::SetThreadAffinity(cpus);
+  const auto start = std::chrono::steady_clock::now();
+  auto next_evict = start + std::chrono::seconds(evict_interval_);
+  for (int n = 1; ; n++) {
+    const auto deadline = start + std::chrono::seconds(static_cast<int64_t>(n) * interval_);
+    std::unique_lock<std::mutex> lock(mu_);
+    if (cv_.wait_until(lock, deadline, [this] { return stop_; })) {
+      return;
+    }
+    lock.unlock();
+
+    const uint64_t ops = current_->GetClientOps();
+    // the status message starts with the operation count
+    std::string latency = current_->GetStatusMsg();
+    latency = latency.substr(latency.find(';') + 1);
+    current_->Reset();
+    points_.push_back({static_cast<double>(n) * interval_, static_cast<double>(ops) / interval_, latency});
+
+    if (evict_interval_ > 0 && std::chrono::steady_clock::now() >= next_evict) {
+      evict();
+      next_evict += std::chrono::seconds(evict_interval_);
+    }
+  }
+}
+
+} // ycsbc
@@ -0,0 +1,106 @@
+//
+//  warmup_curve.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_WARMUP_CURVE_H_
+#define YCSB_C_WARMUP_CURVE_H_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "measurements.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Follows throughput and latency over the transaction phase of a cold
+/// start, i.e. a run that begins with the database closed and its files
+/// evicted from the page cache, and reports how long the caches took to
+/// warm up.
+///
+/// Each interval of warmup.interval seconds gives one point of the curve.
+/// The steady throughput is that of the last quarter of the points; the
+/// warm-up ends at the first point from which every point stays within
+/// warmup.tolerance of it.
+///
+class WarmupCurve {
+ public:
+  ///
+  /// The name of the property that turns cold starts on.
+  ///
+  static const std::string COLD_START_PROPERTY;
+  static const std::string COLD_START_DEFAULT;
+
+  ///
+  /// The name of the property for how often, in seconds, the files are
+  /// evicted again during the run, without closing the database. 0 evicts
+  /// them only before the run.
+  ///
+  static const std::string EVICT_INTERVAL_PROPERTY;
+  static const std::string EVICT_INTERVAL_DEFAULT;
+
+  ///
+  /// The name of the property for the length of a point of the curve, in
+  /// seconds.
+  ///
+  static const std::string INTERVAL_PROPERTY;
+  static const std::string INTERVAL_DEFAULT;
+
+  ///
+  /// The name of the property for how far below the steady throughput a
+  /// point may be and still count as warm, as a fraction.
+  ///
+  static const std::string TOLERANCE_PROPERTY;
+  static const std::string TOLERANCE_DEFAULT;
+
+  void Init(const utils::Properties &p);
+
+  bool enabled() const { return enabled_; }
+
+  ///
+  /// Starts sampling measurements, which must be IntervalMeasurements, as
+  /// CreateMeasurements makes them. evict is called every evict interval.
+  ///
+  void Start(Measurements *measurements, std::function<void()> evict, std::vector<int> cpus);
+
+  ///
+  /// Stops sampling and prints the curve and the warm-up time.
+  ///
+  void Stop();
+
+  WarmupCurve() : enabled_(false), evict_interval_(0), interval_(1), tolerance_(0),
+                  measurements_(nullptr), current_(nullptr), stop_(false) {}
+
+ private:
+  struct Point {
+    double time;
+    double throughput;
+    std::string latency;
+  };
+
+  void Sample(std::function<void()> evict, std::vector<int> cpus);
+
+  bool enabled_;
+  int evict_interval_;
+  int interval_;
+  double tolerance_;
+  IntervalMeasurements *measurements_;
+  Measurements *current_;
+  std::vector<Point> points_;
+  std::thread thread_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool stop_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_WARMUP_CURVE_H_
@@ -6,22 +6,43 @@
 //  Copyright (c) 2014 Jinglei Ren <jinglei@ren.systems>.
 //
 
+#include <csignal>
+#include <cstdio>
 #include <cstring>
 #include <ctime>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <climits>
 #include <string>
 #include <iostream>
 #include <vector>
 #include <thread>
 #include <future>
 #include <chrono>
+#include <fstream>
 #include <iomanip>
+#include <sstream>
 
+#include "bulk_file.h"
 #include "client.h"
 #include "core_workload.h"
 #include "db_factory.h"
+#include "db_wrapper.h"
+#include "event_timeline.h"
+#include "htap_scanners.h"
+#include "load_profile.h"
 #include "measurements.h"
+#include "slo_search.h"
+#include "space_report.h"
+#include "thread_placement.h"
+#include "warmup_curve.h"
+#include "utils/affinity.h"
 #include "utils/countdown_latch.h"
+#include "utils/files.h"
 #include "utils/rate_limit.h"
 #include "utils/timer.h"
 #include "utils/utils.h"
@@ -30,9 +51,16 @@ void UsageMessage(const char *command);
 bool StrStartWith(const char *str, const char *pre);
 void ParseCommandLine(int argc, const char *argv[], ycsbc::utils::Properties &props);
 
-void StatusThread(ycsbc::Measurements *measurements, ycsbc::utils::CountDownLatch *latch, int interval) {
+// Prints a status line every interval seconds until latch is done. With
+// stats_db, the line ends with the engine statistics sampled at the same time.
+void StatusThread(ycsbc::Measurements *measurements, ycsbc::utils::CountDownLatch *latch, int interval,
+                  ycsbc::utils::RateLimiter *rlim, std::string label, ycsbc::DB *stats_db,
+                  std::vector<int> cpus) {
   using namespace std::chrono;
+  ycsbc::utils::SetThreadAffinity(cpus);
   time_point<system_clock> start = system_clock::now();
+  time_point<steady_clock> last = steady_clock::now();
+  uint64_t last_consumed = rlim ? rlim->GetConsumed() : 0;
   bool done = false;
   while (1) {
     time_point<system_clock> now = system_clock::now();
@@ -41,8 +69,33 @@ void StatusThread(ycsbc::Measurements *measurements, ycsbc::utils::CountDownLatc
 
     std::cout << std::put_time(std::localtime(&now_c), "%F %T") << ' '
               << static_cast<long long>(elapsed_time.count()) << " sec: ";
+    if (!label.empty()) {
+      std::cout << '[' << label << "] ";
+    }
+
+    std::cout << measurements->GetStatusMsg();
 
-    std::cout << measurements->GetStatusMsg() << std::endl;
+    if (rlim) {
+      // throughput admitted by the rate limiter since the previous line
+      time_point<steady_clock> steady_now = steady_clock::now();
+      uint64_t consumed = rlim->GetConsumed();
+      duration<double> window = steady_now - last;
+      if (window.count() > 0) {
+        std::cout << " [RATE: target(ops/sec)=" << rlim->GetRate()
+                  << " achieved(ops/sec)=" << (consumed - last_consumed) / window.count() << "]";
+      }
+      last = steady_now;
+      last_consumed = consumed;
+    }
+    std::vector<ycsbc::DB::Field> stats;
+    if (stats_db && stats_db->GetStats(stats) == ycsbc::DB::kOK && !stats.empty()) {
+      std::cout << " [DB:";
+      for (const ycsbc::DB::Field &stat : stats) {
+        std::cout << ' ' << stat.name << '=' << stat.value;
+      }
+      std::cout << ']';
+    }
+    std::cout << std::endl;
 
     if (done) {
       break;
@@ -51,8 +104,14 @@ void StatusThread(ycsbc::Measurements *measurements, ycsbc::utils::CountDownLatc
   };
 }
 
-void RateLimitThread(std::string rate_file, std::vector<ycsbc::utils::RateLimiter *> rate_limiters,
-                     ycsbc::utils::CountDownLatch *latch) {
+// The handle whose engine statistics the status thread samples, if any.
+ycsbc::DB *StatsDB(const ycsbc::utils::Properties &props, const std::vector<ycsbc::DB *> &dbs) {
+  return props.GetProperty("status.dbstats", "false") == "true" ? dbs[0] : nullptr;
+}
+
+void RateLimitThread(std::string rate_file, ycsbc::utils::RateLimiter *rlim,
+                     ycsbc::utils::CountDownLatch *latch, std::vector<int> cpus) {
+  ycsbc::utils::SetThreadAffinity(cpus);
   std::ifstream ifs;
   ifs.open(rate_file);
 
@@ -60,8 +119,6 @@ void RateLimitThread(std::string rate_file, std::vector<ycsbc::utils::RateLimite
     ycsbc::utils::Exception("failed to open: " + rate_file);
   }
 
-  int64_t num_threads = rate_limiters.size();
-
   int64_t last_time = 0;
   while (!ifs.eof()) {
     int64_t next_time;
@@ -78,25 +135,1036 @@ void RateLimitThread(std::string rate_file, std::vector<ycsbc::utils::RateLimite
     }
     last_time = next_time;
 
-    for (auto x : rate_limiters) {
-      x->SetRate(next_rate / num_threads);
+    rlim->SetRate(next_rate);
+  }
+}
+
+std::vector<int> ParseThreadSweep(const std::string &list) {
+  std::vector<int> counts;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    item = ycsbc::utils::Trim(item);
+    if (item.empty()) {
+      continue;
+    }
+    int count = std::stoi(item);
+    if (count <= 0) {
+      throw ycsbc::utils::Exception("invalid thread count in threadsweep: " + item);
+    }
+    counts.push_back(count);
+  }
+  return counts;
+}
+
+// Loads the dataset ycsb-gen wrote to the bulkload.dir directory instead of
+// inserting records one by one: through the database's bulk path with the
+// first handle, or else by inserting the records of the partitions from the
+// first num_threads handles. Returns the number of records loaded and stores
+// the elapsed seconds in runtime.
+int RunBulkLoad(const ycsbc::utils::Properties &props, ycsbc::CoreWorkload *wl,
+                const std::vector<ycsbc::DB *> &dbs, int num_threads, bool init_db, bool cleanup_db,
+                const ycsbc::ThreadPlacement &placement, double *runtime) {
+  const std::string dir = props["bulkload.dir"];
+  const std::string table = props.GetProperty(ycsbc::CoreWorkload::TABLENAME_PROPERTY,
+                                              ycsbc::CoreWorkload::TABLENAME_DEFAULT);
+
+  // the dataset must be the one this workload would load
+  ycsbc::utils::Properties manifest;
+  std::ifstream input(ycsbc::BulkManifestPath(dir));
+  if (!input.is_open()) {
+    std::cerr << "No dataset generated by ycsb-gen in " << dir << std::endl;
+    exit(1);
+  }
+  manifest.Load(input);
+  const uint64_t records = std::stoull(manifest.GetProperty(ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY, "0"));
+  const uint64_t start = std::stoull(manifest.GetProperty(ycsbc::CoreWorkload::INSERT_START_PROPERTY, "0"));
+  if (records != wl->GetLoadRecordCount() || start != wl->GetLoadStart() ||
+      manifest.GetProperty(ycsbc::CoreWorkload::TABLENAME_PROPERTY) != table) {
+    std::cerr << "The dataset in " << dir << " was generated with other recordcount, insertstart or table"
+              << std::endl;
+    exit(1);
+  }
+  const std::vector<std::string> files = ycsbc::ListBulkPartitions(dir);
+
+  ycsbc::utils::Timer<double> timer;
+  timer.Start();
+  if (init_db) {
+    dbs[0]->Init();
+  }
+  ycsbc::DB::Status s = dbs[0]->BulkLoad(table, files);
+  if (init_db) {
+    for (int i = 1; i < num_threads; i++) {
+      dbs[i]->Init();
+    }
+  }
+
+  uint64_t loaded = records;
+  if (s == ycsbc::DB::kNotImplemented) {
+    // no bulk path, so insert the records, one partition per thread at a time
+    std::atomic<uint64_t> inserted(0);
+    std::vector<std::future<void>> threads;
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back(std::async(std::launch::async, [&, t]() {
+        ycsbc::utils::SetThreadAffinity(placement.ClientCpus(t));
+        std::string key;
+        std::vector<ycsbc::DB::Field> values;
+        for (size_t f = t; f < files.size(); f += num_threads) {
+          ycsbc::BulkFileReader reader;
+          reader.Open(files[f]);
+          while (reader.Next(key, values)) {
+            inserted += (dbs[t]->Insert(table, key, values) == ycsbc::DB::kOK);
+          }
+        }
+      }));
+    }
+    for (auto &thread : threads) {
+      thread.get();
+    }
+    loaded = inserted.load();
+  } else if (s != ycsbc::DB::kOK) {
+    std::cerr << "Bulk load of " << dir << " failed" << std::endl;
+    exit(1);
+  } else {
+    // the wrappers did not see the records, so count the dataset instead
+    uint64_t bytes = 0;
+    for (const std::string &file : files) {
+      ycsbc::utils::WalkFiles(file, [&bytes](const std::string &, const struct stat &st) {
+        bytes += st.st_size;
+      });
+    }
+    ycsbc::DBWrapper::CountInsert(bytes, records);
+  }
+  *runtime = timer.End();
+
+  if (cleanup_db) {
+    for (int i = 0; i < num_threads; i++) {
+      dbs[i]->Cleanup();
     }
   }
+  std::cout << "Bulk load " << (s == ycsbc::DB::kOK ? "ingested" : "inserted") << " partitions: "
+            << files.size() << std::endl;
+  return loaded;
+}
+
+// Loads records with the first num_threads handles of dbs.
+// Returns the number of records inserted and stores the elapsed seconds in runtime.
+int RunLoadPhase(const ycsbc::utils::Properties &props, ycsbc::Measurements *measurements,
+                 ycsbc::CoreWorkload *wl, const std::vector<ycsbc::DB *> &dbs, int num_threads,
+                 bool init_db, bool cleanup_db, const ycsbc::ThreadPlacement &placement,
+                 double *runtime) {
+  // ingest a dataset generated offline instead of inserting records
+  if (!props.GetProperty("bulkload.dir", "").empty()) {
+    return RunBulkLoad(props, wl, dbs, num_threads, init_db, cleanup_db, placement, runtime);
+  }
+
+  // print status periodically
+  const bool show_status = (props.GetProperty("status", "false") == "true");
+  const int status_interval = std::stoi(props.GetProperty("status.interval", "10"));
+  // tells apart the status lines of thread groups running side by side
+  const std::string status_label = props.GetProperty("status.label", "");
+
+  const int total_ops = wl->GetLoadRecordCount();
+
+  ycsbc::utils::CountDownLatch latch(num_threads);
+  ycsbc::utils::Timer<double> timer;
+
+  timer.Start();
+  std::future<void> status_future;
+  if (show_status) {
+    status_future = std::async(std::launch::async, StatusThread,
+                               measurements, &latch, status_interval, nullptr, status_label,
+                               StatsDB(props, dbs), placement.AuxCpus());
+  }
+  std::vector<std::future<int>> client_threads;
+  for (int i = 0; i < num_threads; ++i) {
+    int thread_ops = total_ops / num_threads;
+    if (i < total_ops % num_threads) {
+      thread_ops++;
+    }
+
+    client_threads.emplace_back(std::async(std::launch::async, ycsbc::ClientThread, dbs[i], wl,
+                                           measurements, thread_ops, true, init_db, cleanup_db, &latch,
+                                           nullptr, nullptr, placement.ClientCpus(i)));
+  }
+  assert((int)client_threads.size() == num_threads);
+  ycsbc::EventTimeline timeline;
+  timeline.Start(measurements, dbs[0], placement.AuxCpus());
+
+  int sum = 0;
+  for (auto &n : client_threads) {
+    assert(n.valid());
+    sum += n.get();
+  }
+  *runtime = timer.End();
+  timeline.Stop();
+
+  if (show_status) {
+    status_future.get();
+  }
+  return sum;
+}
+
+// Drops the files of the database from the page cache, so that it is read
+// from storage again. The database should be closed by all handles, or its
+// own caches stay warm.
+void EvictDatabase(ycsbc::DB *db) {
+  const std::vector<std::string> paths = db->GetDataPaths();
+  if (paths.empty()) {
+    std::cerr << "coldstart needs a database that reports its data files" << std::endl;
+    exit(1);
+  }
+  ycsbc::utils::Timer<double> timer;
+  timer.Start();
+  uint64_t bytes = 0;
+  for (const std::string &path : paths) {
+    bytes += ycsbc::utils::EvictFromPageCache(path);
+  }
+  std::cout << "Evict size(MB): " << bytes / (1024.0 * 1024.0) << std::endl;
+  std::cout << "Evict time(sec): " << timer.End() << std::endl;
+}
+
+// Runs the transaction phase with the first num_threads handles of dbs.
+// Returns the number of operations done and stores the elapsed seconds in runtime.
+int RunTransactionPhase(const ycsbc::utils::Properties &props, ycsbc::Measurements *measurements,
+                        ycsbc::CoreWorkload *wl, const std::vector<ycsbc::DB *> &dbs, int num_threads,
+                        bool init_db, bool cleanup_db, const ycsbc::ThreadPlacement &placement,
+                        double *runtime) {
+  // print status periodically
+  const bool show_status = (props.GetProperty("status", "false") == "true");
+  const int status_interval = std::stoi(props.GetProperty("status.interval", "10"));
+  // tells apart the status lines of thread groups running side by side
+  const std::string status_label = props.GetProperty("status.label", "");
+
+  // initial ops per second, unlimited if <= 0
+  const int64_t ops_limit = std::stoi(props.GetProperty("limit.ops", "0"));
+  // rate file path for dynamic rate limiting, format "time_stamp_sec new_ops_per_second" per line
+  std::string rate_file = props.GetProperty("limit.file", "");
+  // search for the highest rate meeting a latency SLO, runs until the search completes
+  const bool slo_search = (props.GetProperty(ycsbc::SloSearch::ENABLE_PROPERTY,
+                                             ycsbc::SloSearch::ENABLE_DEFAULT) == "true");
+  ycsbc::SloSearch search;
+  if (slo_search) {
+    if (rate_file != "") {
+      std::cerr << "limit.file cannot be combined with " << ycsbc::SloSearch::ENABLE_PROPERTY << std::endl;
+      exit(1);
+    }
+    search.Init(props);
+  }
+  // scripted load profile, runs until the last segment ends
+  const bool use_profile = props.ContainsKey(ycsbc::LoadProfile::FILE_PROPERTY);
+  ycsbc::LoadProfile profile;
+  if (use_profile) {
+    if (rate_file != "" || slo_search) {
+      std::cerr << ycsbc::LoadProfile::FILE_PROPERTY << " cannot be combined with limit.file or "
+                << ycsbc::SloSearch::ENABLE_PROPERTY << std::endl;
+      exit(1);
+    }
+    profile.Init(props);
+  }
+  std::atomic<bool> stop(false);
+
+  // analytical scans running next to the clients
+  ycsbc::HtapScanners htap;
+  htap.Init(props);
+
+  // throughput and latency over time after a cold start
+  ycsbc::WarmupCurve warmup;
+  warmup.Init(props);
+
+  // stop after this many seconds, 0 for no limit
+  const int max_execution_time = std::stoi(props.GetProperty("maxexecutiontime", "0"));
+  int total_ops = INT_MAX;
+  if (!slo_search && !use_profile) {
+    total_ops = stoi(props.GetProperty(ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY, "0"));
+    if (total_ops <= 0 && max_execution_time > 0) {
+      total_ops = INT_MAX;
+    }
+  }
+
+  // one token bucket shared by all clients, so a stalled client does not waste the budget
+  ycsbc::utils::RateLimiter *rlim = nullptr;
+  if (ops_limit > 0 || rate_file != "" || slo_search || use_profile) {
+    if (slo_search) {
+      // keep the burst small so that lowering the rate takes effect immediately
+      rlim = new ycsbc::utils::RateLimiter(search.start_rate(),
+                                           std::max<int64_t>(num_threads, search.start_rate() / 100));
+    } else if (use_profile) {
+      // rates change every few milliseconds, so a backlog should not carry over
+      rlim = new ycsbc::utils::RateLimiter(profile.start_rate(),
+                                           std::max<int64_t>(num_threads, profile.start_rate() / 1000));
+    } else {
+      rlim = new ycsbc::utils::RateLimiter(ops_limit, ops_limit);
+    }
+  }
+
+  ycsbc::utils::CountDownLatch latch(num_threads);
+  ycsbc::utils::Timer<double> timer;
+
+  timer.Start();
+  std::future<void> status_future;
+  if (show_status) {
+    status_future = std::async(std::launch::async, StatusThread,
+                               measurements, &latch, status_interval, rlim, status_label,
+                               StatsDB(props, dbs), placement.AuxCpus());
+  }
+  std::vector<std::future<int>> client_threads;
+  for (int i = 0; i < num_threads; ++i) {
+    int thread_ops = total_ops / num_threads;
+    if (i < total_ops % num_threads) {
+      thread_ops++;
+    }
+    // handles are cleaned up below, after the workload has finished the run
+    client_threads.emplace_back(std::async(std::launch::async, ycsbc::ClientThread, dbs[i], wl,
+                                           measurements, thread_ops, false, init_db, false, &latch,
+                                           rlim, &stop, placement.ClientCpus(i)));
+  }
+
+  htap.Start(measurements, placement.AuxCpus());
+  if (warmup.enabled()) {
+    ycsbc::DB *db = dbs[0];
+    warmup.Start(measurements, [db]() { EvictDatabase(db); }, placement.AuxCpus());
+  }
+  ycsbc::EventTimeline timeline;
+  timeline.Start(measurements, dbs[0], placement.AuxCpus());
+
+  std::future<void> rlim_future;
+  if (rate_file != "") {
+    rlim_future = std::async(std::launch::async, RateLimitThread, rate_file, rlim, &latch,
+                             placement.AuxCpus());
+  }
+
+  std::future<void> slo_future;
+  if (slo_search) {
+    slo_future = std::async(std::launch::async, &ycsbc::SloSearch::Run, &search,
+                            measurements, rlim, &stop, placement.AuxCpus());
+  }
+
+  std::future<void> profile_future;
+  if (use_profile) {
+    profile_future = std::async(std::launch::async, &ycsbc::LoadProfile::Run, &profile,
+                                measurements, rlim, &stop, placement.AuxCpus());
+  }
+
+  std::future<void> deadline_future;
+  if (max_execution_time > 0) {
+    deadline_future = std::async(std::launch::async, [&latch, &stop, max_execution_time]() {
+      if (!latch.AwaitFor(max_execution_time)) {
+        stop.store(true);
+      }
+    });
+  }
+
+  assert((int)client_threads.size() == num_threads);
+
+  int sum = 0;
+  for (auto &n : client_threads) {
+    assert(n.valid());
+    sum += n.get();
+  }
+  *runtime = timer.End();
+  htap.Stop();
+  warmup.Stop();
+  timeline.Stop();
+
+  if (show_status) {
+    status_future.get();
+  }
+  if (rate_file != "") {
+    rlim_future.get();
+  }
+  if (slo_search) {
+    slo_future.get();
+  }
+  if (use_profile) {
+    profile_future.get();
+  }
+  if (max_execution_time > 0) {
+    deadline_future.get();
+  }
+  delete rlim;
+
+  try {
+    // the checks read through the bare handle, so their reads stay out of the latency report
+    ycsbc::DBWrapper *wrapper = dynamic_cast<ycsbc::DBWrapper *>(dbs[0]);
+    wl->FinishRun(wrapper != nullptr ? *wrapper->unmeasured() : *dbs[0]);
+  } catch (const ycsbc::utils::Exception &e) {
+    std::cerr << "Caught exception: " << e.what() << std::endl;
+    exit(1);
+  }
+  if (cleanup_db) {
+    for (int i = 0; i < num_threads; i++) {
+      dbs[i]->Cleanup();
+    }
+  }
+  return sum;
+}
+
+// Checks every record with the first num_threads handles of dbs.
+// Returns whether all records passed and stores the elapsed seconds in runtime.
+bool RunVerifyPhase(const ycsbc::utils::Properties &props, ycsbc::Measurements *measurements,
+                    ycsbc::CoreWorkload *wl, const std::vector<ycsbc::DB *> &dbs, int num_threads,
+                    bool init_db, bool cleanup_db, const ycsbc::ThreadPlacement &placement,
+                    double *runtime) {
+  if (props.GetProperty(ycsbc::CoreWorkload::DATA_INTEGRITY_PROPERTY,
+                        ycsbc::CoreWorkload::DATA_INTEGRITY_DEFAULT) != "true") {
+    std::cerr << "Verify needs " << ycsbc::CoreWorkload::DATA_INTEGRITY_PROPERTY << "=true" << std::endl;
+    exit(1);
+  }
+  // print status periodically
+  const bool show_status = (props.GetProperty("status", "false") == "true");
+  const int status_interval = std::stoi(props.GetProperty("status.interval", "10"));
+  const std::string status_label = props.GetProperty("status.label", "");
+
+  const uint64_t total_ops = wl->GetVerifyRecordCount();
+
+  ycsbc::utils::CountDownLatch latch(num_threads);
+  ycsbc::utils::Timer<double> timer;
+
+  timer.Start();
+  std::future<void> status_future;
+  if (show_status) {
+    status_future = std::async(std::launch::async, StatusThread,
+                               measurements, &latch, status_interval, nullptr, status_label,
+                               StatsDB(props, dbs), placement.AuxCpus());
+  }
+  std::vector<std::future<int>> client_threads;
+  for (int i = 0; i < num_threads; ++i) {
+    int thread_ops = total_ops / num_threads;
+    if (i < static_cast<int>(total_ops % num_threads)) {
+      thread_ops++;
+    }
+    client_threads.emplace_back(std::async(std::launch::async, ycsbc::VerifyThread, dbs[i], wl,
+                                           thread_ops, init_db, cleanup_db, &latch,
+                                           placement.ClientCpus(i)));
+  }
+  for (auto &n : client_threads) {
+    assert(n.valid());
+    n.get();
+  }
+  *runtime = timer.End();
+
+  if (show_status) {
+    status_future.get();
+  }
+  return wl->FinishVerify();
+}
+
+// One phase of a schedule file, with the properties it overrides.
+struct Phase {
+  std::string name;
+  std::vector<std::pair<std::string, std::string>> overrides;
+};
+
+// Parses a schedule file, where a line "[name]" starts a phase and the
+// "key=value" lines that follow override properties for that phase.
+std::vector<Phase> ParseSchedule(const std::string &file) {
+  std::ifstream input(file);
+  if (!input.is_open()) {
+    throw ycsbc::utils::Exception("failed to open: " + file);
+  }
+  std::vector<Phase> phases;
+  std::string line;
+  while (std::getline(input, line)) {
+    line = ycsbc::utils::Trim(line);
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    if (line.front() == '[' && line.back() == ']') {
+      phases.push_back(Phase{line.substr(1, line.size() - 2), {}});
+      continue;
+    }
+    size_t pos = line.find('=');
+    if (pos == std::string::npos || phases.empty()) {
+      throw ycsbc::utils::Exception("invalid schedule line: " + line);
+    }
+    phases.back().overrides.emplace_back(ycsbc::utils::Trim(line.substr(0, pos)),
+                                         ycsbc::utils::Trim(line.substr(pos + 1)));
+  }
+  if (phases.empty()) {
+    throw ycsbc::utils::Exception("empty schedule: " + file);
+  }
+  return phases;
+}
+
+ycsbc::utils::Properties PhaseProperties(const ycsbc::utils::Properties &props, const Phase &phase) {
+  ycsbc::utils::Properties p = props;
+  for (const auto &kv : phase.overrides) {
+    p.SetProperty(kv.first, kv.second);
+  }
+  return p;
+}
+
+// A snapshot directory holds the engine checkpoint in kSnapshotData and the
+// workload state at the time it was taken in kSnapshotState.
+const char kSnapshotData[] = "/db";
+const char kSnapshotState[] = "/ycsb.snapshot";
+
+// Writes what a later invocation needs to continue from the data wl left to
+// file, replacing it only once the new state is complete.
+void WriteWorkloadState(const ycsbc::utils::Properties &props, ycsbc::CoreWorkload *wl,
+                        const std::string &file) {
+  ycsbc::utils::Properties state;
+  wl->SaveState(state);
+  const double record_bytes = ycsbc::SpaceReport::RecordBytes(props);
+  if (record_bytes > 0) {
+    state.SetProperty(ycsbc::SpaceReport::RECORD_BYTES_PROPERTY, std::to_string(record_bytes));
+  }
+  std::ofstream output(file + ".tmp");
+  output << "# workload state, loaded by later invocations" << std::endl;
+  state.Store(output);
+  output.close();
+  if (output.fail() || rename((file + ".tmp").c_str(), file.c_str())) {
+    std::cerr << "Failed to write " << file << std::endl;
+    exit(1);
+  }
+}
+
+// Checkpoints the database into dir with a handle of its own, together with
+// the workload state a later run needs to pick up where the load left off.
+void TakeSnapshot(ycsbc::utils::Properties &props, ycsbc::Measurements *measurements,
+                  ycsbc::CoreWorkload *wl, const std::string &dir) {
+  ycsbc::utils::Timer<double> timer;
+  timer.Start();
+  ycsbc::utils::MakeDirectory(dir);
+  ycsbc::DB *db = ycsbc::DBFactory::CreateDB(&props, measurements);
+  db->Init();
+  ycsbc::DB::Status s = db->Checkpoint(dir + kSnapshotData);
+  db->Cleanup();
+  delete db;
+  if (s != ycsbc::DB::kOK) {
+    std::cerr << "Failed to checkpoint " << props["dbname"] << " into " << dir << std::endl;
+    exit(1);
+  }
+
+  WriteWorkloadState(props, wl, dir + kSnapshotState);
+  std::cout << "Snapshot time(sec): " << timer.End() << std::endl;
+}
+
+// Puts the database back as it was when the snapshot in dir was taken. No
+// handle may have the database open. If props is given, the workload state
+// saved with the snapshot is loaded into it.
+void RestoreSnapshot(ycsbc::DB *db, const std::string &dir, ycsbc::utils::Properties *props) {
+  ycsbc::utils::Timer<double> timer;
+  timer.Start();
+  if (props != nullptr) {
+    std::ifstream state(dir + kSnapshotState);
+    if (!state.is_open()) {
+      std::cerr << "No snapshot in " << dir << std::endl;
+      exit(1);
+    }
+    props->Load(state);
+  }
+  if (db->Restore(dir + kSnapshotData) != ycsbc::DB::kOK) {
+    std::cerr << "Failed to restore the snapshot in " << dir << std::endl;
+    exit(1);
+  }
+  std::cout << "Restore time(sec): " << timer.End() << std::endl;
+}
+
+// Runs the phases of a schedule back to back on the same open handles.
+void RunSchedule(const ycsbc::utils::Properties &props, const std::vector<Phase> &phases,
+                 ycsbc::Measurements *measurements, const std::vector<ycsbc::DB *> &dbs,
+                 const ycsbc::ThreadPlacement &placement) {
+  uint64_t record_count = std::stoull(props.GetProperty(ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY, "0"));
+  const std::string restore_dir = props.GetProperty("restore", "");
+  bool restored = true;
+  const bool cold_start = ycsbc::utils::StrToBool(props.GetProperty(ycsbc::WarmupCurve::COLD_START_PROPERTY,
+                                                                    ycsbc::WarmupCurve::COLD_START_DEFAULT));
+
+  for (const Phase &phase : phases) {
+    ycsbc::utils::Properties p = PhaseProperties(props, phase);
+    const std::string type = p.GetProperty("phase.type", "run");
+
+    if (type == "sleep") {
+      const int seconds = std::stoi(p.GetProperty("phase.sleep", "0"));
+      std::this_thread::sleep_for(std::chrono::seconds(seconds));
+      std::cout << "Phase " << phase.name << " slept(sec): " << seconds << std::endl;
+      continue;
+    }
+
+    // with -restore, every run phase starts from the snapshot, and with
+    // coldstart from a closed database with nothing cached
+    if (type == "run") {
+      const bool restore = !restore_dir.empty() && !restored;
+      if (restore || cold_start) {
+        for (auto db : dbs) {
+          db->Cleanup();
+        }
+        if (restore) {
+          RestoreSnapshot(dbs[0], restore_dir, nullptr);
+          record_count = std::stoull(props.GetProperty(ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY, "0"));
+        }
+        if (cold_start) {
+          EvictDatabase(dbs[0]);
+        }
+        for (auto db : dbs) {
+          db->Init();
+        }
+      }
+      restored = false;
+    }
+
+    // later phases see the records inserted by earlier ones
+    bool has_record_count = false;
+    for (const auto &kv : phase.overrides) {
+      has_record_count |= (kv.first == ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY);
+    }
+    if ((type == "run" || type == "verify") && !has_record_count) {
+      p.SetProperty(ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY, std::to_string(record_count));
+    }
+
+    const int num_threads = std::stoi(p.GetProperty("threadcount", "1"));
+    ycsbc::CoreWorkload *wl = ycsbc::CreateWorkload(p, measurements);
+    if (wl == nullptr) {
+      std::cerr << "Unknown workload name " << p.GetProperty(ycsbc::CoreWorkload::WORKLOAD_PROPERTY) << std::endl;
+      exit(1);
+    }
+    wl->Init(p);
+    measurements->Reset();
+    ycsbc::SpaceReport space;
+    space.Start();
+
+    double runtime;
+    int sum;
+    if (type == "load") {
+      sum = RunLoadPhase(p, measurements, wl, dbs, num_threads, false, false, placement, &runtime);
+    } else if (type == "verify") {
+      RunVerifyPhase(p, measurements, wl, dbs, num_threads, false, false, placement, &runtime);
+      sum = wl->GetVerifyRecordCount();
+    } else {
+      sum = RunTransactionPhase(p, measurements, wl, dbs, num_threads, false, false, placement, &runtime);
+    }
+    record_count = wl->GetRecordCount();
+    const uint64_t live_records = wl->GetLiveRecordCount();
+    if (type != "verify" && props.ContainsKey("statefile")) {
+      WriteWorkloadState(props, wl, props["statefile"]);
+    }
+    delete wl;
+
+    std::cout << "Phase " << phase.name << " runtime(sec): " << runtime << std::endl;
+    std::cout << "Phase " << phase.name << " operations(ops): " << sum << std::endl;
+    std::cout << "Phase " << phase.name << " throughput(ops/sec): " << sum / runtime << std::endl;
+    std::cout << "Phase " << phase.name << " latency(us): " << measurements->GetStatusMsg() << std::endl;
+    space.Print("Phase " + phase.name, dbs[0], live_records, props);
+  }
+}
+
+// Parses a comma separated list of tenant names.
+std::vector<std::string> ParseTenants(const std::string &list) {
+  std::vector<std::string> names;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    item = ycsbc::utils::Trim(item);
+    if (item.empty()) {
+      continue;
+    }
+    if (std::find(names.begin(), names.end(), item) != names.end()) {
+      throw ycsbc::utils::Exception("duplicate tenant in tenants: " + item);
+    }
+    names.push_back(item);
+  }
+  return names;
+}
+
+// A workload run by its own thread group, with its own rate limit and
+// measurements, next to the other tenants on the same database.
+struct Tenant {
+  std::string name;
+  ycsbc::utils::Properties props;
+  ycsbc::Measurements *measurements;
+  ycsbc::CoreWorkload *wl;
+  std::vector<ycsbc::DB *> dbs;
+  int num_threads;
+  ycsbc::ThreadPlacement placement;
+};
+
+// Runs the tenants listed by the "tenants" property at the same time.
+// Properties prefixed by a tenant name apply to that tenant only, e.g.
+// "reader.threadcount=4" or "reader.limit.ops=1000".
+void RunTenants(ycsbc::utils::Properties &props, bool do_load, bool do_transaction, bool do_verify) {
+  const std::vector<std::string> names = ParseTenants(props.GetProperty("tenants"));
+  if (names.empty()) {
+    std::cerr << "No tenant in tenants" << std::endl;
+    exit(1);
+  }
+
+  std::vector<Tenant> tenants(names.size());
+  int total_threads = 0;
+  for (size_t t = 0; t < names.size(); t++) {
+    Tenant &tenant = tenants[t];
+    tenant.name = names[t];
+    tenant.props = props.Overlay(tenant.name + ".");
+    tenant.props.SetProperty("status.label", tenant.name);
+    tenant.num_threads = std::stoi(tenant.props.GetProperty("threadcount", "1"));
+    total_threads += tenant.num_threads;
+
+    tenant.measurements = ycsbc::CreateMeasurements(&tenant.props);
+    if (tenant.measurements == nullptr) {
+      std::cerr << "Unknown measurements name for tenant " << tenant.name << std::endl;
+      exit(1);
+    }
+    tenant.wl = ycsbc::CreateWorkload(tenant.props, tenant.measurements);
+    if (tenant.wl == nullptr) {
+      std::cerr << "Unknown workload name for tenant " << tenant.name << ": "
+                << tenant.props.GetProperty(ycsbc::CoreWorkload::WORKLOAD_PROPERTY) << std::endl;
+      exit(1);
+    }
+    tenant.wl->Init(tenant.props);
+
+    // the database is shared, so its handles see the global properties and
+    // report to the tenant's measurements; a tenant can only pick among the
+    // tables the database is opened with
+    const std::vector<std::string> global_tables = ycsbc::CoreWorkload::GetTableNames(props);
+    for (const std::string &table : ycsbc::CoreWorkload::GetTableNames(tenant.props)) {
+      if (std::find(global_tables.begin(), global_tables.end(), table) == global_tables.end()) {
+        std::cerr << "Table " << table << " of tenant " << tenant.name
+                  << " is not among the global tables" << std::endl;
+        exit(1);
+      }
+    }
+    for (int i = 0; i < tenant.num_threads; i++) {
+      ycsbc::DB *db = ycsbc::DBFactory::CreateDB(&props, tenant.measurements);
+      if (db == nullptr) {
+        std::cerr << "Unknown database name " << props["dbname"] << std::endl;
+        exit(1);
+      }
+      db->Init();
+      tenant.dbs.push_back(db);
+    }
+  }
+
+  // every tenant gets cpus of its own
+  ycsbc::ThreadPlacement placement;
+  placement.Init(props, total_threads);
+  int first_thread = 0;
+  for (Tenant &tenant : tenants) {
+    tenant.placement = placement.Offset(first_thread);
+    first_thread += tenant.num_threads;
+  }
+
+  // each tenant loads its own records, one tenant after the other
+  if (do_load) {
+    for (Tenant &tenant : tenants) {
+      double runtime;
+      int sum = RunLoadPhase(tenant.props, tenant.measurements, tenant.wl, tenant.dbs, tenant.num_threads,
+                             false, false, tenant.placement, &runtime);
+
+      std::cout << "Tenant " << tenant.name << " load runtime(sec): " << runtime << std::endl;
+      std::cout << "Tenant " << tenant.name << " load operations(ops): " << sum << std::endl;
+      std::cout << "Tenant " << tenant.name << " load throughput(ops/sec): " << sum / runtime << std::endl;
+    }
+  }
+
+  std::this_thread::sleep_for(std::chrono::seconds(stoi(props.GetProperty("sleepafterload", "0"))));
+
+  if (do_transaction) {
+    for (Tenant &tenant : tenants) {
+      tenant.measurements->Reset();
+    }
+    std::vector<double> runtimes(tenants.size());
+    std::vector<std::future<int>> runs;
+    for (size_t t = 0; t < tenants.size(); t++) {
+      Tenant &tenant = tenants[t];
+      runs.emplace_back(std::async(std::launch::async, RunTransactionPhase, std::cref(tenant.props),
+                                   tenant.measurements, tenant.wl, std::cref(tenant.dbs), tenant.num_threads,
+                                   false, false, std::cref(tenant.placement), &runtimes[t]));
+    }
+    std::vector<int> sums;
+    for (auto &run : runs) {
+      sums.push_back(run.get());
+    }
+
+    for (size_t t = 0; t < tenants.size(); t++) {
+      const Tenant &tenant = tenants[t];
+      std::cout << "Tenant " << tenant.name << " run runtime(sec): " << runtimes[t] << std::endl;
+      std::cout << "Tenant " << tenant.name << " run operations(ops): " << sums[t] << std::endl;
+      std::cout << "Tenant " << tenant.name << " run throughput(ops/sec): " << sums[t] / runtimes[t] << std::endl;
+      std::cout << "Tenant " << tenant.name << " run latency(us): " << tenant.measurements->GetStatusMsg() << std::endl;
+    }
+  }
+
+  bool verified = true;
+  if (do_verify) {
+    for (Tenant &tenant : tenants) {
+      tenant.measurements->Reset();
+      double runtime;
+      verified &= RunVerifyPhase(tenant.props, tenant.measurements, tenant.wl, tenant.dbs, tenant.num_threads,
+                                 false, false, tenant.placement, &runtime);
+      std::cout << "Tenant " << tenant.name << " verify runtime(sec): " << runtime << std::endl;
+    }
+  }
+
+  for (Tenant &tenant : tenants) {
+    for (ycsbc::DB *db : tenant.dbs) {
+      db->Cleanup();
+      delete db;
+    }
+    delete tenant.wl;
+    delete tenant.measurements;
+  }
+  if (!verified) {
+    exit(1);
+  }
+}
+
+// Stops the bindings that wipe their database on open from doing so.
+void KeepExistingData(ycsbc::utils::Properties &props) {
+  for (const char *destroy : {"rocksdb.destroy", "leveldb.destroy"}) {
+    if (props.ContainsKey(destroy)) {
+      props.SetProperty(destroy, "false");
+    }
+  }
+}
+
+// Writes in a child process that is killed with SIGKILL at a random point,
+// then reopens the database in this process, times the reopen (including
+// recovery) and the first read, and checks that every load and run insert
+// the child saw acknowledged survived intact. Returns whether they all did.
+bool RunCrashTest(ycsbc::utils::Properties &props, bool do_transaction) {
+  const int min_delay = std::stoi(props.GetProperty("crash.mindelay", "1000"));
+  const int max_delay = std::stoi(props.GetProperty("crash.maxdelay", "5000"));
+  if (min_delay < 0 || max_delay < min_delay) {
+    std::cerr << "Invalid crash.mindelay or crash.maxdelay" << std::endl;
+    exit(1);
+  }
+  if (!props.GetProperty(ycsbc::CoreWorkload::TABLES_PROPERTY).empty()) {
+    std::cerr << "crashtest does not support tables" << std::endl;
+    exit(1);
+  }
+  // deterministic values, so that what survived can be checked
+  props.SetProperty(ycsbc::CoreWorkload::DATA_INTEGRITY_PROPERTY, "true");
+
+  const int num_threads = std::stoi(props.GetProperty("threadcount", "1"));
+  const uint64_t first_key = std::stoull(props.GetProperty(ycsbc::CoreWorkload::INSERT_START_PROPERTY,
+                                                           ycsbc::CoreWorkload::INSERT_START_DEFAULT));
+  uint64_t end_key = first_key +
+      std::stoull(props.GetProperty(ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY, "0"));
+  // the run inserts at most one record per operation, from where the load stopped
+  if (do_transaction) {
+    const int op_count = std::stoi(props.GetProperty(ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY, "0"));
+    if (op_count <= 0) {
+      std::cerr << "crashtest with -run needs operationcount" << std::endl;
+      exit(1);
+    }
+    ycsbc::Measurements *measurements = ycsbc::CreateMeasurements(&props);
+    ycsbc::CoreWorkload *wl = ycsbc::CreateWorkload(props, measurements);
+    if (measurements == nullptr || wl == nullptr) {
+      std::cerr << "Unknown measurements or workload name" << std::endl;
+      exit(1);
+    }
+    wl->Init(props);
+    end_key = std::max<uint64_t>(end_key, wl->GetRecordCount() + op_count);
+    delete wl;
+    delete measurements;
+  }
+
+  // one flag per record, shared with the child
+  void *mem = mmap(nullptr, std::max<uint64_t>(end_key, 1), PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (mem == MAP_FAILED) {
+    throw ycsbc::utils::Exception(std::string("crashtest mmap: ") + strerror(errno));
+  }
+  std::atomic<uint8_t> *acks = static_cast<std::atomic<uint8_t> *>(mem);
+
+  std::cout.flush();
+  pid_t pid = fork();
+  if (pid < 0) {
+    throw ycsbc::utils::Exception(std::string("crashtest fork: ") + strerror(errno));
+  }
+  if (pid == 0) {
+    ycsbc::Measurements *measurements = ycsbc::CreateMeasurements(&props);
+    ycsbc::CoreWorkload *wl = ycsbc::CreateWorkload(props, measurements);
+    if (measurements == nullptr || wl == nullptr) {
+      std::cerr << "Unknown measurements or workload name" << std::endl;
+      _exit(1);
+    }
+    wl->Init(props);
+    wl->SetInsertAcks(acks, end_key);
+    ycsbc::ThreadPlacement placement;
+    placement.Init(props, num_threads);
+    std::vector<ycsbc::DB *> dbs;
+    for (int i = 0; i < num_threads; i++) {
+      dbs.push_back(ycsbc::DBFactory::CreateDB(&props, measurements));
+      if (dbs.back() == nullptr) {
+        std::cerr << "Unknown database name " << props["dbname"] << std::endl;
+        _exit(1);
+      }
+    }
+
+    double runtime;
+    RunLoadPhase(props, measurements, wl, dbs, num_threads, true, false, placement, &runtime);
+    if (do_transaction) {
+      RunTransactionPhase(props, measurements, wl, dbs, num_threads, false, false, placement, &runtime);
+    }
+    // keep the database open, so that the kill still finds it running
+    std::cout << "Crash writer finished before the kill" << std::endl;
+    while (true) {
+      pause();
+    }
+  }
+
+  const int delay = static_cast<int>(ycsbc::utils::ThreadLocalRandomDouble(min_delay, max_delay + 1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+  int status;
+  if (waitpid(pid, &status, WNOHANG) == 0) {
+    kill(pid, SIGKILL);
+    waitpid(pid, &status, 0);
+  }
+  if (!WIFSIGNALED(status) || WTERMSIG(status) != SIGKILL) {
+    std::cerr << "Crash writer exited before the kill" << std::endl;
+    exit(1);
+  }
+  uint64_t acked = 0;
+  for (uint64_t k = first_key; k < end_key; k++) {
+    acked += acks[k].load();
+  }
+  std::cout << "Crash killed writer after(ms): " << delay << std::endl;
+  std::cout << "Crash acknowledged inserts: " << acked << std::endl;
+
+  // reopening must not wipe what the writer left
+  KeepExistingData(props);
+  ycsbc::Measurements *measurements = ycsbc::CreateMeasurements(&props);
+  ycsbc::CoreWorkload *wl = ycsbc::CreateWorkload(props, measurements);
+  wl->Init(props);
+  std::vector<ycsbc::DB *> dbs;
+  for (int i = 0; i < num_threads; i++) {
+    dbs.push_back(ycsbc::DBFactory::CreateDB(&props, measurements));
+  }
+
+  // the first handle opens the engine, which recovers from the crash
+  ycsbc::utils::Timer<double, std::milli> reopen_timer;
+  reopen_timer.Start();
+  dbs[0]->Init();
+  const double reopen = reopen_timer.End();
+
+  ycsbc::utils::Timer<double, std::micro> read_timer;
+  read_timer.Start();
+  wl->VerifyRecord(*dbs[0], first_key);
+  const double first_read = read_timer.End();
+
+  std::cout << "Recovery reopen time(ms): " << reopen << std::endl;
+  std::cout << "Recovery first read latency(us): " << first_read << std::endl;
+
+  // check every record the writer may have inserted, in parallel
+  std::atomic<uint64_t> lost(0);
+  std::atomic<uint64_t> corrupt(0);
+  std::atomic<uint64_t> unacked(0);
+  std::vector<std::future<void>> checks;
+  for (int i = 0; i < num_threads; i++) {
+    checks.emplace_back(std::async(std::launch::async, [&, i]() {
+      if (i > 0) {
+        dbs[i]->Init();
+      }
+      for (uint64_t k = first_key + i; k < end_key; k += num_threads) {
+        ycsbc::DB::Status s = wl->VerifyRecord(*dbs[i], k);
+        if (s == ycsbc::DB::kNotFound) {
+          lost += acks[k].load();
+        } else if (s != ycsbc::DB::kOK) {
+          corrupt++;
+        } else if (!acks[k].load()) {
+          unacked++;
+        }
+      }
+      dbs[i]->Cleanup();
+    }));
+  }
+  for (auto &check : checks) {
+    check.get();
+  }
+  const bool ok = (lost == 0 && corrupt == 0);
+  std::cout << "Recovery check: acknowledged=" << acked << " lost=" << lost << " corrupt=" << corrupt
+            << " unacknowledged but present=" << unacked << (ok ? " OK" : " FAILED") << std::endl;
+
+  for (ycsbc::DB *db : dbs) {
+    delete db;
+  }
+  delete wl;
+  delete measurements;
+  munmap(mem, std::max<uint64_t>(end_key, 1));
+  return ok;
 }
 
 int main(const int argc, const char *argv[]) {
   ycsbc::utils::Properties props;
   ParseCommandLine(argc, argv, props);
+  // before any database is opened, so that bindings register their listeners
+  ycsbc::EventTimeline::Init(props);
 
   const bool do_load = (props.GetProperty("doload", "false") == "true");
   const bool do_transaction = (props.GetProperty("dotransaction", "false") == "true");
-  if (!do_load && !do_transaction) {
+  const bool do_verify = (props.GetProperty("doverify", "false") == "true");
+
+  // kill a writer mid-run and measure how the database comes back
+  if (props.GetProperty("crashtest", "false") == "true") {
+    return RunCrashTest(props, do_transaction) ? 0 : 1;
+  }
+
+  // phases to run back to back instead of the load and transaction phases
+  std::vector<Phase> schedule;
+  if (props.ContainsKey("schedule")) {
+    schedule = ParseSchedule(props["schedule"]);
+    for (const Phase &phase : schedule) {
+      const std::string type = PhaseProperties(props, phase).GetProperty("phase.type", "run");
+      if (type != "load" && type != "run" && type != "verify" && type != "sleep") {
+        std::cerr << "Unknown phase type " << type << " in phase " << phase.name << std::endl;
+        exit(1);
+      }
+    }
+  } else if (!do_load && !do_transaction && !do_verify) {
     std::cerr << "No operation to do" << std::endl;
     exit(1);
   }
 
+  const std::string snapshot_dir = props.GetProperty("snapshot", "");
+  const std::string restore_dir = props.GetProperty("restore", "");
+  if (!restore_dir.empty() && do_load) {
+    std::cerr << "-restore cannot be combined with -load" << std::endl;
+    exit(1);
+  }
+  if (!snapshot_dir.empty() && !schedule.empty()) {
+    std::cerr << "-snapshot cannot be combined with schedule" << std::endl;
+    exit(1);
+  }
+  // close and evict the database before the transaction phase
+  const bool cold_start = ycsbc::utils::StrToBool(props.GetProperty(ycsbc::WarmupCurve::COLD_START_PROPERTY,
+                                                                    ycsbc::WarmupCurve::COLD_START_DEFAULT));
+
+  // workloads with thread groups of their own, run side by side
+  if (!props.GetProperty("tenants", "").empty()) {
+    if (!schedule.empty() || props.ContainsKey("threadsweep")) {
+      std::cerr << "tenants cannot be combined with schedule or threadsweep" << std::endl;
+      exit(1);
+    }
+    if (ycsbc::EventTimeline::Enabled()) {
+      std::cerr << "tenants cannot be combined with timeline.file" << std::endl;
+      exit(1);
+    }
+    if (!snapshot_dir.empty() || !restore_dir.empty() || props.ContainsKey("statefile") || cold_start) {
+      std::cerr << "tenants cannot be combined with -snapshot, -restore, statefile or coldstart" << std::endl;
+      exit(1);
+    }
+    RunTenants(props, do_load, do_transaction, do_verify);
+    return 0;
+  }
+
   const int num_threads = stoi(props.GetProperty("threadcount", "1"));
 
+  // run the transaction phase once per thread count, against the same open DB
+  const std::vector<int> thread_sweep = ParseThreadSweep(props.GetProperty("threadsweep", ""));
+  int max_threads = num_threads;
+  for (int n : thread_sweep) {
+    max_threads = std::max(max_threads, n);
+  }
+  for (const Phase &phase : schedule) {
+    max_threads = std::max(max_threads, std::stoi(PhaseProperties(props, phase).GetProperty("threadcount", "1")));
+  }
+
+  // pin client threads and keep auxiliary threads off their cpus
+  ycsbc::ThreadPlacement placement;
+  placement.Init(props, max_threads);
+
   ycsbc::Measurements *measurements = ycsbc::CreateMeasurements(&props);
   if (measurements == nullptr) {
     std::cerr << "Unknown measurements name" << std::endl;
@@ -104,7 +1172,7 @@ int main(const int argc, const char *argv[]) {
   }
 
   std::vector<ycsbc::DB *> dbs;
-  for (int i = 0; i < num_threads; i++) {
+  for (int i = 0; i < max_threads; i++) {
     ycsbc::DB *db = ycsbc::DBFactory::CreateDB(&props, measurements);
     if (db == nullptr) {
       std::cerr << "Unknown database name " << props["dbname"] << std::endl;
@@ -113,119 +1181,177 @@ int main(const int argc, const char *argv[]) {
     dbs.push_back(db);
   }
 
-  ycsbc::CoreWorkload wl;
-  wl.Init(props);
-
-  // print status periodically
-  const bool show_status = (props.GetProperty("status", "false") == "true");
-  const int status_interval = std::stoi(props.GetProperty("status.interval", "10"));
-
-  // load phase
-  if (do_load) {
-    const int total_ops = stoi(props[ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY]);
-
-    ycsbc::utils::CountDownLatch latch(num_threads);
-    ycsbc::utils::Timer<double> timer;
-
-    timer.Start();
-    std::future<void> status_future;
-    if (show_status) {
-      status_future = std::async(std::launch::async, StatusThread,
-                                 measurements, &latch, status_interval);
-    }
-    std::vector<std::future<int>> client_threads;
-    for (int i = 0; i < num_threads; ++i) {
-      int thread_ops = total_ops / num_threads;
-      if (i < total_ops % num_threads) {
-        thread_ops++;
-      }
+  // start from the snapshot, with the record count it was taken at
+  if (!restore_dir.empty()) {
+    KeepExistingData(props);
+    RestoreSnapshot(dbs[0], restore_dir, &props);
+  }
 
-      client_threads.emplace_back(std::async(std::launch::async, ycsbc::ClientThread, dbs[i], &wl,
-                                             thread_ops, true, true, !do_transaction, &latch, nullptr));
+  // continue from the data an earlier invocation left, unless starting over
+  const std::string state_file = props.GetProperty("statefile", "");
+  if (!state_file.empty() && restore_dir.empty() && !do_load) {
+    std::ifstream state(state_file);
+    if (state.is_open()) {
+      props.Load(state);
     }
-    assert((int)client_threads.size() == num_threads);
+  }
 
-    int sum = 0;
-    for (auto &n : client_threads) {
-      assert(n.valid());
-      sum += n.get();
+  if (!schedule.empty()) {
+    for (auto db : dbs) {
+      db->Init();
     }
-    double runtime = timer.End();
-
-    if (show_status) {
-      status_future.wait();
+    // cold starts reopen the database before every run phase
+    if (cold_start) {
+      KeepExistingData(props);
+    }
+    RunSchedule(props, schedule, measurements, dbs, placement);
+    for (auto db : dbs) {
+      db->Cleanup();
+      delete db;
     }
+    return 0;
+  }
+
+  ycsbc::CoreWorkload *wl = ycsbc::CreateWorkload(props, measurements);
+  if (wl == nullptr) {
+    std::cerr << "Unknown workload name " << props.GetProperty(ycsbc::CoreWorkload::WORKLOAD_PROPERTY) << std::endl;
+    exit(1);
+  }
+  wl->Init(props);
+
+  // disk usage and amplification of each phase
+  ycsbc::SpaceReport space;
+
+  // load phase
+  if (do_load) {
+    space.Start();
+    double runtime;
+    int sum = RunLoadPhase(props, measurements, wl, dbs, num_threads, true,
+                           (!do_transaction && !do_verify) || (do_transaction && cold_start), placement, &runtime);
 
     std::cout << "Load runtime(sec): " << runtime << std::endl;
     std::cout << "Load operations(ops): " << sum << std::endl;
     std::cout << "Load throughput(ops/sec): " << sum / runtime << std::endl;
+    space.Print("Load", dbs[0], wl->GetLiveRecordCount(), props);
+  }
+
+  // snapshot the loaded database, or the one the run starts from
+  if (!snapshot_dir.empty()) {
+    TakeSnapshot(props, measurements, wl, snapshot_dir);
   }
 
   measurements->Reset();
   std::this_thread::sleep_for(std::chrono::seconds(stoi(props.GetProperty("sleepafterload", "0"))));
 
+  // the load phase closed its handles, so the run opens the database cold
+  if (do_transaction && cold_start) {
+    KeepExistingData(props);
+    EvictDatabase(dbs[0]);
+  }
 
   // transaction phase
-  if (do_transaction) {
-    // initial ops per second, unlimited if <= 0
-    const int64_t ops_limit = std::stoi(props.GetProperty("limit.ops", "0"));
-    // rate file path for dynamic rate limiting, format "time_stamp_sec new_ops_per_second" per line
-    std::string rate_file = props.GetProperty("limit.file", "");
-
-    const int total_ops = stoi(props[ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY]);
-
-    ycsbc::utils::CountDownLatch latch(num_threads);
-    ycsbc::utils::Timer<double> timer;
-
-    timer.Start();
-    std::future<void> status_future;
-    if (show_status) {
-      status_future = std::async(std::launch::async, StatusThread,
-                                 measurements, &latch, status_interval);
-    }
-    std::vector<std::future<int>> client_threads;
-    std::vector<ycsbc::utils::RateLimiter *> rate_limiters;
-    for (int i = 0; i < num_threads; ++i) {
-      int thread_ops = total_ops / num_threads;
-      if (i < total_ops % num_threads) {
-        thread_ops++;
+  if (do_transaction && thread_sweep.empty()) {
+    space.Start();
+    double runtime;
+    int sum = RunTransactionPhase(props, measurements, wl, dbs, num_threads, !do_load || cold_start, !do_verify,
+                                  placement, &runtime);
+
+    std::cout << "Run runtime(sec): " << runtime << std::endl;
+    std::cout << "Run operations(ops): " << sum << std::endl;
+    std::cout << "Run throughput(ops/sec): " << sum / runtime << std::endl;
+    space.Print("Run", dbs[0], wl->GetLiveRecordCount(), props);
+  } else if (do_transaction) {
+    // handles are shared by all points, so open the ones the load phase did not
+    for (int i = (do_load && !cold_start) ? num_threads : 0; i < max_threads; i++) {
+      dbs[i]->Init();
+    }
+    // seconds to wait between points, e.g. to let compactions settle
+    const int settle = std::stoi(props.GetProperty("threadsweep.settle", "0"));
+
+    std::vector<double> throughputs;
+    for (size_t p = 0; p < thread_sweep.size(); p++) {
+      const int n = thread_sweep[p];
+      if (p > 0 && (!restore_dir.empty() || cold_start)) {
+        // every point starts from the snapshot, or cold
+        for (int i = 0; i < max_threads; i++) {
+          dbs[i]->Cleanup();
+        }
+        if (!restore_dir.empty()) {
+          RestoreSnapshot(dbs[0], restore_dir, nullptr);
+        }
+        if (cold_start) {
+          EvictDatabase(dbs[0]);
+        }
+        for (int i = 0; i < max_threads; i++) {
+          dbs[i]->Init();
+        }
       }
-      ycsbc::utils::RateLimiter *rlim = nullptr;
-      if (ops_limit > 0 || rate_file != "") {
-        int64_t per_thread_ops = ops_limit / num_threads;
-        rlim = new ycsbc::utils::RateLimiter(per_thread_ops, per_thread_ops);
+      if (p > 0 && !restore_dir.empty()) {
+        // forget the keys the previous point inserted
+        delete wl;
+        wl = ycsbc::CreateWorkload(props, measurements);
+        wl->Init(props);
       }
-      rate_limiters.push_back(rlim);
-      client_threads.emplace_back(std::async(std::launch::async, ycsbc::ClientThread, dbs[i], &wl,
-                                             thread_ops, false, !do_load, true, &latch, rlim));
-    }
+      if (p > 0) {
+        std::this_thread::sleep_for(std::chrono::seconds(settle));
+      }
+      measurements->Reset();
+      space.Start();
 
-    std::future<void> rlim_future;
-    if (rate_file != "") {
-      rlim_future = std::async(std::launch::async, RateLimitThread, rate_file, rate_limiters, &latch);
-    }
+      double runtime;
+      int sum = RunTransactionPhase(props, measurements, wl, dbs, n, false, false,
+                                    placement, &runtime);
+      throughputs.push_back(sum / runtime);
 
-    assert((int)client_threads.size() == num_threads);
+      std::cout << "Sweep threads: " << n << std::endl;
+      std::cout << "Sweep runtime(sec): " << runtime << std::endl;
+      std::cout << "Sweep operations(ops): " << sum << std::endl;
+      std::cout << "Sweep throughput(ops/sec): " << throughputs.back() << std::endl;
+      std::cout << "Sweep latency(us): " << measurements->GetStatusMsg() << std::endl;
+      space.Print("Sweep", dbs[0], wl->GetLiveRecordCount(), props);
+    }
 
-    int sum = 0;
-    for (auto &n : client_threads) {
-      assert(n.valid());
-      sum += n.get();
+    // efficiency is per-thread throughput relative to the first point
+    const double base = throughputs[0] / thread_sweep[0];
+    std::cout << "Thread sweep: threads throughput(ops/sec) speedup efficiency" << std::endl;
+    for (size_t p = 0; p < thread_sweep.size(); p++) {
+      const double speedup = throughputs[p] / throughputs[0];
+      const double efficiency = throughputs[p] / (base * thread_sweep[p]);
+      std::cout << "  " << thread_sweep[p] << ' ' << throughputs[p] << ' '
+                << speedup << ' ' << efficiency << std::endl;
     }
-    double runtime = timer.End();
 
-    if (show_status) {
-      status_future.wait();
+    // the verify phase cleans up the handles it uses
+    for (int i = do_verify ? num_threads : 0; i < max_threads; i++) {
+      dbs[i]->Cleanup();
     }
+  }
 
-    std::cout << "Run runtime(sec): " << runtime << std::endl;
-    std::cout << "Run operations(ops): " << sum << std::endl;
-    std::cout << "Run throughput(ops/sec): " << sum / runtime << std::endl;
+  if (!state_file.empty() && (do_load || do_transaction)) {
+    WriteWorkloadState(props, wl, state_file);
   }
 
-  for (int i = 0; i < num_threads; i++) {
+  // verify phase
+  bool verified = true;
+  if (do_verify) {
+    measurements->Reset();
+    space.Start();
+    double runtime;
+    verified = RunVerifyPhase(props, measurements, wl, dbs, num_threads, !do_load && !do_transaction, true,
+                              placement, &runtime);
+
+    std::cout << "Verify runtime(sec): " << runtime << std::endl;
+    std::cout << "Verify operations(ops): " << wl->GetVerifyRecordCount() << std::endl;
+    std::cout << "Verify throughput(ops/sec): " << wl->GetVerifyRecordCount() / runtime << std::endl;
+    std::cout << "Verify latency(us): " << measurements->GetStatusMsg() << std::endl;
+    space.Print("Verify", dbs[0], wl->GetLiveRecordCount(), props);
+  }
+
+  for (int i = 0; i < max_threads; i++) {
     delete dbs[i];
   }
+  delete wl;
+  return verified ? 0 : 1;
 }
 
 void ParseCommandLine(int argc, const char *argv[], ycsbc::utils::Properties &props) {
@@ -237,6 +1363,19 @@ void ParseCommandLine(int argc, const char *argv[], ycsbc::utils::Properties &pr
     } else if (strcmp(argv[argindex], "-run") == 0 || strcmp(argv[argindex], "-t") == 0) {
       props.SetProperty("dotransaction", "true");
       argindex++;
+    } else if (strcmp(argv[argindex], "-verify") == 0) {
+      props.SetProperty("doverify", "true");
+      argindex++;
+    } else if (strcmp(argv[argindex], "-snapshot") == 0 || strcmp(argv[argindex], "-restore") == 0) {
+      const char *flag = argv[argindex];
+      argindex++;
+      if (argindex >= argc) {
+        UsageMessage(argv[0]);
+        std::cerr << "Missing argument value for " << flag << std::endl;
+        exit(0);
+      }
+      props.SetProperty(flag + 1, argv[argindex]);
+      argindex++;
     } else if (strcmp(argv[argindex], "-threads") == 0) {
       argindex++;
       if (argindex >= argc) {
@@ -312,6 +1451,9 @@ void UsageMessage(const char *command) {
       "  -load: run the loading phase of the workload\n"
       "  -t: run the transactions phase of the workload\n"
       "  -run: same as -t\n"
+      "  -verify: check every record after the other phases (needs dataintegrity=true)\n"
+      "  -snapshot dir: checkpoint the database into dir after the load phase\n"
+      "  -restore dir: start every run phase from the snapshot in dir\n"
       "  -threads n: execute using n threads (default: 1)\n"
       "  -db dbname: specify the name of the DB to use (default: basic)\n"
       "  -P propertyfile: load properties from the given file. Multiple files can\n"
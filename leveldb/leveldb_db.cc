@@ -14,6 +14,9 @@
 #include <leveldb/options.h>
 #include <leveldb/write_batch.h>
 
+#include <cstdio>
+#include <sstream>
+
 namespace {
   const std::string PROP_NAME = "leveldb.dbname";
   const std::string PROP_NAME_DEFAULT = "";
@@ -84,6 +87,10 @@ void LeveldbDB::Init() {
   } else {
     throw utils::Exception("unknown format");
   }
+  // LevelDB has a single keyspace, which the tables would silently share
+  if (CoreWorkload::GetTableNames(props).size() > 1) {
+    throw utils::Exception("LevelDB does not support multiple tables");
+  }
   fieldcount_ = std::stoi(props.GetProperty(CoreWorkload::FIELD_COUNT_PROPERTY,
                                             CoreWorkload::FIELD_COUNT_DEFAULT));
   field_prefix_ = props.GetProperty(CoreWorkload::FIELD_NAME_PREFIX,
@@ -123,6 +130,7 @@ void LeveldbDB::Cleanup() {
     return;
   }
   delete db_;
+  db_ = nullptr;
 }
 
 void LeveldbDB::GetOptions(const utils::Properties &props, leveldb::Options *opt) {
@@ -473,6 +481,90 @@ DB::Status LeveldbDB::DeleteCompKey(const std::string &table, const std::string
   return kOK;
 }
 
+DB::Status LeveldbDB::ScanAll(const std::string &table, const ScanVisitor &visit) {
+  // records of the row and column formats span several entries
+  if (format_ != kSingleEntry) {
+    return kNotImplemented;
+  }
+  leveldb::Iterator *db_iter = db_->NewIterator(leveldb::ReadOptions());
+  for (db_iter->SeekToFirst(); db_iter->Valid(); db_iter->Next()) {
+    if (!visit(db_iter->key().size() + db_iter->value().size())) {
+      break;
+    }
+  }
+  leveldb::Status s = db_iter->status();
+  delete db_iter;
+  if (!s.ok()) {
+    throw utils::Exception(std::string("LevelDB ScanAll: ") + s.ToString());
+  }
+  return kOK;
+}
+
+DB::Status LeveldbDB::BatchWrite(const std::string &table, std::vector<Mutation> &batch) {
+  leveldb::WriteOptions wopt;
+  leveldb::WriteBatch wb;
+
+  std::string data;
+  for (Mutation &m : batch) {
+    if (format_ == kSingleEntry) {
+      if (m.type == Mutation::kInsert) {
+        data.clear();
+        SerializeRow(m.values, &data);
+        wb.Put(m.key, data);
+      } else {
+        wb.Delete(m.key);
+      }
+    } else if (m.type == Mutation::kInsert) {
+      for (Field &field : m.values) {
+        wb.Put(BuildCompKey(m.key, field.name), field.value);
+      }
+    } else {
+      for (int i = 0; i < fieldcount_; i++) {
+        wb.Delete(BuildCompKey(m.key, field_prefix_ + std::to_string(i)));
+      }
+    }
+  }
+
+  leveldb::Status s = db_->Write(wopt, &wb);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("LevelDB Write: ") + s.ToString());
+  }
+  return kOK;
+}
+
+std::vector<std::string> LeveldbDB::GetDataPaths() {
+  return {props_->GetProperty(PROP_NAME, PROP_NAME_DEFAULT)};
+}
+
+DB::Status LeveldbDB::GetStats(std::vector<Field> &stats) {
+  const std::lock_guard<std::mutex> lock(mu_);
+  if (db_ == nullptr) {
+    return kError;
+  }
+  std::string value;
+  if (db_->GetProperty("leveldb.approximate-memory-usage", &value)) {
+    stats.push_back({"leveldb.approximate-memory-usage", value});
+  }
+  // the rows of the compaction table of leveldb.stats, one per non-empty level
+  if (db_->GetProperty("leveldb.stats", &value)) {
+    std::istringstream table(value);
+    std::string line;
+    while (std::getline(table, line)) {
+      int level, files;
+      double size, time, read, write;
+      if (sscanf(line.c_str(), "%d %d %lf %lf %lf %lf", &level, &files, &size, &time, &read, &write) != 6) {
+        continue;
+      }
+      const std::string prefix = "leveldb.level" + std::to_string(level) + ".";
+      stats.push_back({prefix + "files", std::to_string(files)});
+      stats.push_back({prefix + "size_mb", std::to_string(size)});
+      stats.push_back({prefix + "compact_read_mb", std::to_string(read)});
+      stats.push_back({prefix + "compact_write_mb", std::to_string(write)});
+    }
+  }
+  return kOK;
+}
+
 DB *NewLeveldbDB() {
   return new LeveldbDB;
 }
@@ -54,6 +54,14 @@ class LeveldbDB : public DB {
     return (this->*(method_delete_))(table, key);
   }
 
+  Status ScanAll(const std::string &table, const ScanVisitor &visit);
+
+  std::vector<std::string> GetDataPaths();
+
+  Status GetStats(std::vector<Field> &stats);
+
+  Status BatchWrite(const std::string &table, std::vector<Mutation> &batch);
+
  private:
   enum LdbFormat {
     kSingleEntry,
@@ -14,8 +14,10 @@
 #endif
 
 #include "lmdb_db.h"
+#include "core/bulk_file.h"
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "utils/files.h"
 #include "utils/properties.h"
 #include "utils/utils.h"
 
@@ -46,11 +48,8 @@ namespace {
 
 namespace ycsbc {
 
-size_t LmdbDB::field_count_;
-std::string LmdbDB::field_prefix_;
-
 MDB_env *LmdbDB::env_;
-MDB_dbi LmdbDB::dbi_;
+std::unordered_map<std::string, MDB_dbi> LmdbDB::table_dbis_;
 int LmdbDB::ref_cnt_ = 0;
 std::mutex LmdbDB::mutex_;
 
@@ -63,11 +62,6 @@ void LmdbDB::Init() {
     return;
   }
 
-  field_count_ = std::stoi(props.GetProperty(CoreWorkload::FIELD_COUNT_PROPERTY,
-                                            CoreWorkload::FIELD_COUNT_DEFAULT));
-  field_prefix_ = props.GetProperty(CoreWorkload::FIELD_NAME_PREFIX,
-                                    CoreWorkload::FIELD_NAME_PREFIX_DEFAULT);
-
   int ret;
   int env_opt = 0;
   if (props.GetProperty(PROP_NOSYNC, PROP_NOSYNC_DEFAULT) == "true") {
@@ -96,6 +90,15 @@ void LmdbDB::Init() {
       throw utils::Exception(std::string("Init mdb_env_set_mapsize: ") + mdb_strerror(ret));
     }
   }
+  // with a list of tables, each table is a named database of the environment
+  const bool named_tables = !props.GetProperty(CoreWorkload::TABLES_PROPERTY).empty();
+  const std::vector<std::string> tables = CoreWorkload::GetTableNames(props);
+  if (named_tables) {
+    ret = mdb_env_set_maxdbs(env_, tables.size());
+    if (ret) {
+      throw utils::Exception(std::string("Init mdb_env_set_maxdbs: ") + mdb_strerror(ret));
+    }
+  }
   const std::string &db_path = props.GetProperty(PROP_DBPATH, PROP_DBPATH_DEFAULT);
   if (db_path == "") {
     throw utils::Exception("LMDB db path is missing");
@@ -114,9 +117,13 @@ void LmdbDB::Init() {
   if (ret) {
     throw utils::Exception(std::string("Init mdb_txn_begin: ") + mdb_strerror(ret));
   }
-  ret = mdb_open(txn, nullptr, 0, &dbi_);
-  if (ret) {
-    throw utils::Exception(std::string("Init mdb_open: ") + mdb_strerror(ret));
+  for (const std::string &table : tables) {
+    MDB_dbi dbi;
+    ret = mdb_open(txn, named_tables ? table.c_str() : nullptr, named_tables ? MDB_CREATE : 0, &dbi);
+    if (ret) {
+      throw utils::Exception(std::string("Init mdb_open: ") + mdb_strerror(ret));
+    }
+    table_dbis_[table] = dbi;
   }
   ret = mdb_txn_commit(txn);
   if (ret) {
@@ -129,8 +136,12 @@ void LmdbDB::Cleanup() {
   if (--ref_cnt_) {
     return;
   }
-  mdb_close(env_, dbi_);
+  for (auto &table : table_dbis_) {
+    mdb_close(env_, table.second);
+  }
+  table_dbis_.clear();
   mdb_env_close(env_);
+  env_ = nullptr;
 }
 
 void LmdbDB::SerializeRow(const std::vector<Field> &values, std::string *data) {
@@ -182,7 +193,18 @@ void LmdbDB::DeserializeRow(std::vector<Field> *values, const char *data_ptr, si
     p += len;
     values->push_back({field, value});
   }
-  assert(values->size() == field_count_);
+}
+
+MDB_dbi LmdbDB::Dbi(const std::string &table) {
+  // with a single table, any table name maps to it as before
+  if (table_dbis_.size() == 1) {
+    return table_dbis_.begin()->second;
+  }
+  auto it = table_dbis_.find(table);
+  if (it == table_dbis_.end()) {
+    throw utils::Exception("LMDB unknown table: " + table);
+  }
+  return it->second;
 }
 
 DB::Status LmdbDB::Read(const std::string &table, const std::string &key, const std::vector<std::string> *fields,
@@ -199,7 +221,7 @@ DB::Status LmdbDB::Read(const std::string &table, const std::string &key, const
   if (ret) {
     throw utils::Exception(std::string("Read mdb_txn_begin: ") + mdb_strerror(ret));
   }
-  ret = mdb_get(txn, dbi_, &key_slice, &val_slice);
+  ret = mdb_get(txn, Dbi(table), &key_slice, &val_slice);
   if (ret == MDB_NOTFOUND) {
     s = kNotFound;
     goto cleanup;
@@ -231,7 +253,7 @@ DB::Status LmdbDB::Scan(const std::string &table, const std::string &key, int le
   if (ret) {
     throw utils::Exception(std::string("Scan mdb_txn_begin: ") + mdb_strerror(ret));
   }
-  ret = mdb_cursor_open(txn, dbi_, &cursor);
+  ret = mdb_cursor_open(txn, Dbi(table), &cursor);
   if (ret) {
     throw utils::Exception(std::string("Scan mdb_cursor_open: ") + mdb_strerror(ret));
   }
@@ -270,8 +292,12 @@ DB::Status LmdbDB::Update(const std::string &table, const std::string &key, std:
   if (ret) {
     throw utils::Exception(std::string("Update mdb_txn_begin: ") + mdb_strerror(ret));
   }
-  ret = mdb_get(txn, dbi_, &key_slice, &val_slice);
-  if (ret) {
+  ret = mdb_get(txn, Dbi(table), &key_slice, &val_slice);
+  if (ret == MDB_NOTFOUND) {
+    mdb_txn_abort(txn);
+    return kNotFound;
+  } else if (ret) {
+    mdb_txn_abort(txn);
     throw utils::Exception(std::string("Update mdb_get: ") + mdb_strerror(ret));
   }
   std::vector<Field> current_values;
@@ -292,7 +318,7 @@ DB::Status LmdbDB::Update(const std::string &table, const std::string &key, std:
   SerializeRow(current_values, &data);
   val_slice.mv_data = const_cast<char *>(data.data());
   val_slice.mv_size = data.size();
-  ret = mdb_put(txn, dbi_, &key_slice, &val_slice, 0);
+  ret = mdb_put(txn, Dbi(table), &key_slice, &val_slice, 0);
   if (ret) {
     throw utils::Exception(std::string("Update mdb_put: ") + mdb_strerror(ret));
   }
@@ -321,7 +347,7 @@ DB::Status LmdbDB::Insert(const std::string &table, const std::string &key, std:
   if (ret) {
     throw utils::Exception(std::string("Insert mdb_txn_begin: ") + mdb_strerror(ret));
   }
-  ret = mdb_put(txn, dbi_, &key_slice, &val_slice, 0);
+  ret = mdb_put(txn, Dbi(table), &key_slice, &val_slice, 0);
   if (ret) {
     throw utils::Exception(std::string("Insert mdb_put: ") + mdb_strerror(ret));
   }
@@ -344,8 +370,12 @@ DB::Status LmdbDB::Delete(const std::string &table, const std::string &key) {
   if (ret) {
     throw utils::Exception(std::string("Delete mdb_txn_begin: ") + mdb_strerror(ret));
   }
-  ret = mdb_del(txn, dbi_, &key_slice, nullptr);
-  if (ret) {
+  ret = mdb_del(txn, Dbi(table), &key_slice, nullptr);
+  if (ret == MDB_NOTFOUND) {
+    mdb_txn_abort(txn);
+    return kNotFound;
+  } else if (ret) {
+    mdb_txn_abort(txn);
     throw utils::Exception(std::string("Delete mdb_del: ") + mdb_strerror(ret));
   }
   ret = mdb_txn_commit(txn);
@@ -355,6 +385,266 @@ DB::Status LmdbDB::Delete(const std::string &table, const std::string &key) {
   return kOK;
 }
 
+DB::Status LmdbDB::ScanAll(const std::string &table, const ScanVisitor &visit) {
+  MDB_txn *txn;
+  MDB_cursor *cursor;
+  MDB_val key_slice, val_slice;
+
+  // the read transaction holds a reader slot, so pages freed meanwhile cannot be reused
+  int ret = mdb_txn_begin(env_, nullptr, MDB_RDONLY, &txn);
+  if (ret) {
+    throw utils::Exception(std::string("ScanAll mdb_txn_begin: ") + mdb_strerror(ret));
+  }
+  ret = mdb_cursor_open(txn, Dbi(table), &cursor);
+  if (ret) {
+    mdb_txn_abort(txn);
+    throw utils::Exception(std::string("ScanAll mdb_cursor_open: ") + mdb_strerror(ret));
+  }
+  ret = mdb_cursor_get(cursor, &key_slice, &val_slice, MDB_FIRST);
+  while (!ret) {
+    if (!visit(key_slice.mv_size + val_slice.mv_size)) {
+      break;
+    }
+    ret = mdb_cursor_get(cursor, &key_slice, &val_slice, MDB_NEXT);
+  }
+  mdb_cursor_close(cursor);
+  mdb_txn_abort(txn);
+  if (ret && ret != MDB_NOTFOUND) {
+    throw utils::Exception(std::string("ScanAll mdb_cursor_get: ") + mdb_strerror(ret));
+  }
+  return kOK;
+}
+
+DB::Status LmdbDB::BatchWrite(const std::string &table, std::vector<Mutation> &batch) {
+  MDB_txn *txn;
+  MDB_val key_slice, val_slice;
+  const MDB_dbi dbi = Dbi(table);
+
+  int ret;
+  ret = mdb_txn_begin(env_, nullptr, 0, &txn);
+  if (ret) {
+    throw utils::Exception(std::string("BatchWrite mdb_txn_begin: ") + mdb_strerror(ret));
+  }
+  std::string data;
+  for (Mutation &m : batch) {
+    key_slice.mv_data = static_cast<void *>(const_cast<char *>(m.key.data()));
+    key_slice.mv_size = m.key.size();
+    if (m.type == Mutation::kInsert) {
+      data.clear();
+      SerializeRow(m.values, &data);
+      val_slice.mv_data = static_cast<void *>(const_cast<char *>(data.data()));
+      val_slice.mv_size = data.size();
+      ret = mdb_put(txn, dbi, &key_slice, &val_slice, 0);
+      if (ret) {
+        mdb_txn_abort(txn);
+        throw utils::Exception(std::string("BatchWrite mdb_put: ") + mdb_strerror(ret));
+      }
+    } else {
+      ret = mdb_del(txn, dbi, &key_slice, nullptr);
+      if (ret && ret != MDB_NOTFOUND) {
+        mdb_txn_abort(txn);
+        throw utils::Exception(std::string("BatchWrite mdb_del: ") + mdb_strerror(ret));
+      }
+    }
+  }
+  ret = mdb_txn_commit(txn);
+  if (ret) {
+    throw utils::Exception(std::string("BatchWrite mdb_txn_commit: ") + mdb_strerror(ret));
+  }
+  return kOK;
+}
+
+// LMDB admits one write transaction at a time, so these wait for each other
+// instead of conflicting
+class LmdbDB::LmdbTransaction : public DB::Transaction {
+ public:
+  LmdbTransaction(LmdbDB *owner, MDB_txn *txn, MDB_dbi dbi) : owner_(owner), txn_(txn), dbi_(dbi) {}
+
+  // an unfinished transaction would keep the write lock
+  ~LmdbTransaction() {
+    if (txn_ != nullptr) {
+      mdb_txn_abort(txn_);
+    }
+  }
+
+  Status Read(const std::string &key, const std::vector<std::string> *fields,
+              std::vector<Field> &result) {
+    MDB_val key_slice, val_slice;
+    key_slice.mv_data = static_cast<void *>(const_cast<char *>(key.data()));
+    key_slice.mv_size = key.size();
+
+    int ret = mdb_get(txn_, dbi_, &key_slice, &val_slice);
+    if (ret == MDB_NOTFOUND) {
+      return kNotFound;
+    } else if (ret) {
+      throw utils::Exception(std::string("Transaction mdb_get: ") + mdb_strerror(ret));
+    }
+    if (fields != nullptr) {
+      owner_->DeserializeRowFilter(&result, static_cast<char *>(val_slice.mv_data), val_slice.mv_size, *fields);
+    } else {
+      owner_->DeserializeRow(&result, static_cast<char *>(val_slice.mv_data), val_slice.mv_size);
+    }
+    return kOK;
+  }
+
+  Status Write(const std::string &key, std::vector<Field> &values) {
+    MDB_val key_slice, val_slice;
+    key_slice.mv_data = static_cast<void *>(const_cast<char *>(key.data()));
+    key_slice.mv_size = key.size();
+
+    std::string data;
+    owner_->SerializeRow(values, &data);
+    val_slice.mv_data = static_cast<void *>(const_cast<char *>(data.data()));
+    val_slice.mv_size = data.size();
+
+    int ret = mdb_put(txn_, dbi_, &key_slice, &val_slice, 0);
+    if (ret) {
+      throw utils::Exception(std::string("Transaction mdb_put: ") + mdb_strerror(ret));
+    }
+    return kOK;
+  }
+
+  Status Commit() {
+    // the handle is freed even if the commit fails
+    int ret = mdb_txn_commit(txn_);
+    txn_ = nullptr;
+    if (ret) {
+      throw utils::Exception(std::string("Transaction mdb_txn_commit: ") + mdb_strerror(ret));
+    }
+    return kOK;
+  }
+
+  void Rollback() {
+    if (txn_ != nullptr) {
+      mdb_txn_abort(txn_);
+      txn_ = nullptr;
+    }
+  }
+
+ private:
+  LmdbDB *owner_;
+  MDB_txn *txn_;
+  MDB_dbi dbi_;
+};
+
+DB::Transaction *LmdbDB::BeginTransaction(const std::string &table) {
+  MDB_txn *txn;
+  int ret = mdb_txn_begin(env_, nullptr, 0, &txn);
+  if (ret) {
+    throw utils::Exception(std::string("Transaction mdb_txn_begin: ") + mdb_strerror(ret));
+  }
+  return new LmdbTransaction(this, txn, Dbi(table));
+}
+
+DB::Status LmdbDB::Checkpoint(const std::string &dir) {
+  utils::MakeDirectory(dir);
+  // a compacting copy of one read transaction, without free pages
+  int ret = mdb_env_copy2(env_, dir.c_str(), MDB_CP_COMPACT);
+  if (ret) {
+    throw utils::Exception(std::string("Checkpoint mdb_env_copy2: ") + mdb_strerror(ret));
+  }
+  return kOK;
+}
+
+DB::Status LmdbDB::Restore(const std::string &dir) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  if (env_) {
+    throw utils::Exception("LMDB Restore: the environment is open");
+  }
+  const std::string &db_path = props_->GetProperty(PROP_DBPATH, PROP_DBPATH_DEFAULT);
+  if (db_path == "") {
+    throw utils::Exception("LMDB db path is missing");
+  }
+  utils::MakeDirectory(db_path);
+  utils::RemoveFile(db_path + "/lock.mdb");
+  utils::CopyFile(dir + "/data.mdb", db_path + "/data.mdb");
+  return kOK;
+}
+
+DB::Status LmdbDB::BulkLoad(const std::string &table, const std::vector<std::string> &files) {
+  // keys arrive in order, so every put appends to the last page; commit now
+  // and then to bound the dirty pages of one transaction
+  const uint64_t kRecordsPerTxn = 100000;
+  MDB_txn *txn = nullptr;
+  MDB_cursor *cursor = nullptr;
+  uint64_t records = 0;
+  int ret;
+  for (const std::string &file : files) {
+    BulkFileReader reader;
+    reader.Open(file);
+    std::string key;
+    std::vector<Field> values;
+    std::string data;
+    while (reader.Next(key, values)) {
+      if (txn == nullptr) {
+        ret = mdb_txn_begin(env_, nullptr, 0, &txn);
+        if (ret) {
+          throw utils::Exception(std::string("BulkLoad mdb_txn_begin: ") + mdb_strerror(ret));
+        }
+        ret = mdb_cursor_open(txn, Dbi(table), &cursor);
+        if (ret) {
+          throw utils::Exception(std::string("BulkLoad mdb_cursor_open: ") + mdb_strerror(ret));
+        }
+      }
+      data.clear();
+      SerializeRow(values, &data);
+      MDB_val key_slice, val_slice;
+      key_slice.mv_data = static_cast<void *>(const_cast<char *>(key.data()));
+      key_slice.mv_size = key.size();
+      val_slice.mv_data = static_cast<void *>(const_cast<char *>(data.data()));
+      val_slice.mv_size = data.size();
+      ret = mdb_cursor_put(cursor, &key_slice, &val_slice, MDB_APPEND);
+      if (ret) {
+        throw utils::Exception(std::string("BulkLoad mdb_cursor_put: ") + mdb_strerror(ret));
+      }
+      if (++records % kRecordsPerTxn == 0) {
+        mdb_cursor_close(cursor);
+        ret = mdb_txn_commit(txn);
+        txn = nullptr;
+        if (ret) {
+          throw utils::Exception(std::string("BulkLoad mdb_txn_commit: ") + mdb_strerror(ret));
+        }
+      }
+    }
+  }
+  if (txn != nullptr) {
+    mdb_cursor_close(cursor);
+    ret = mdb_txn_commit(txn);
+    if (ret) {
+      throw utils::Exception(std::string("BulkLoad mdb_txn_commit: ") + mdb_strerror(ret));
+    }
+  }
+  return kOK;
+}
+
+std::vector<std::string> LmdbDB::GetDataPaths() {
+  return {props_->GetProperty(PROP_DBPATH, PROP_DBPATH_DEFAULT)};
+}
+
+DB::Status LmdbDB::GetStats(std::vector<Field> &stats) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  if (env_ == nullptr) {
+    return kError;
+  }
+  // the B-tree of the main database, and how much of the map is in use
+  MDB_stat stat;
+  if (mdb_env_stat(env_, &stat) == 0) {
+    stats.push_back({"lmdb.depth", std::to_string(stat.ms_depth)});
+    stats.push_back({"lmdb.branch_pages", std::to_string(stat.ms_branch_pages)});
+    stats.push_back({"lmdb.leaf_pages", std::to_string(stat.ms_leaf_pages)});
+    stats.push_back({"lmdb.overflow_pages", std::to_string(stat.ms_overflow_pages)});
+    stats.push_back({"lmdb.entries", std::to_string(stat.ms_entries)});
+  }
+  MDB_envinfo info;
+  if (mdb_env_info(env_, &info) == 0) {
+    stats.push_back({"lmdb.map_size", std::to_string(info.me_mapsize)});
+    stats.push_back({"lmdb.last_pgno", std::to_string(info.me_last_pgno)});
+    stats.push_back({"lmdb.last_txnid", std::to_string(info.me_last_txnid)});
+    stats.push_back({"lmdb.num_readers", std::to_string(info.me_numreaders)});
+  }
+  return kOK;
+}
+
 DB *NewLmdbDB() {
   return new LmdbDB;
 }
@@ -10,6 +10,7 @@
 
 #include <string>
 #include <mutex>
+#include <unordered_map>
 
 #include "core/db.h"
 
@@ -38,17 +39,34 @@ class LmdbDB : public DB {
 
   Status Delete(const std::string &table, const std::string &key);
 
+  Status ScanAll(const std::string &table, const ScanVisitor &visit);
+
+  Status BatchWrite(const std::string &table, std::vector<Mutation> &batch);
+
+  Transaction *BeginTransaction(const std::string &table);
+
+  Status Checkpoint(const std::string &dir);
+
+  Status Restore(const std::string &dir);
+
+  Status BulkLoad(const std::string &table, const std::vector<std::string> &files);
+
+  std::vector<std::string> GetDataPaths();
+
+  Status GetStats(std::vector<Field> &stats);
+
  private:
+  class LmdbTransaction;
+
   void SerializeRow(const std::vector<Field> &values, std::string *data);
   void DeserializeRowFilter(std::vector<Field> *values, const char *data_ptr, size_t data_len,
                             const std::vector<std::string> &fields);
   void DeserializeRow(std::vector<Field> *values, const char *data_ptr, size_t data_len);
-
-  static size_t field_count_;
-  static std::string field_prefix_;
+  static MDB_dbi Dbi(const std::string &table);
 
   static MDB_env *env_;
-  static MDB_dbi dbi_;
+  // database of each table
+  static std::unordered_map<std::string, MDB_dbi> table_dbis_;
   static int ref_cnt_;
   static std::mutex mutex_;
 };
@@ -8,17 +8,29 @@
 
 #include "rocksdb_db.h"
 
+#include "core/bulk_file.h"
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "core/event_timeline.h"
+#include "utils/files.h"
 #include "utils/utils.h"
 
 #include <rocksdb/cache.h>
 #include <rocksdb/filter_policy.h>
+#include <rocksdb/listener.h>
 #include <rocksdb/merge_operator.h>
+#include <rocksdb/sst_file_writer.h>
+#include <rocksdb/statistics.h>
 #include <rocksdb/status.h>
+#include <rocksdb/utilities/checkpoint.h>
 #include <rocksdb/utilities/options_util.h>
 #include <rocksdb/write_batch.h>
 
+#include <future>
+#include <iostream>
+#include <map>
+#include <mutex>
+
 namespace {
   const std::string PROP_NAME = "rocksdb.dbname";
   const std::string PROP_NAME_DEFAULT = "";
@@ -29,6 +41,9 @@ namespace {
   const std::string PROP_MERGEUPDATE = "rocksdb.mergeupdate";
   const std::string PROP_MERGEUPDATE_DEFAULT = "false";
 
+  const std::string PROP_TRANSACTION = "rocksdb.transaction";
+  const std::string PROP_TRANSACTION_DEFAULT = "none";
+
   const std::string PROP_DESTROY = "rocksdb.destroy";
   const std::string PROP_DESTROY_DEFAULT = "false";
 
@@ -104,17 +119,101 @@ namespace {
   const std::string PROP_FS_URI = "rocksdb.fs_uri";
   const std::string PROP_FS_URI_DEFAULT = "";
 
+  const std::string PROP_STATISTICS = "rocksdb.statistics";
+  const std::string PROP_STATISTICS_DEFAULT = "false";
+
   static std::shared_ptr<rocksdb::Env> env_guard;
   static std::shared_ptr<rocksdb::Cache> block_cache;
 #if ROCKSDB_MAJOR < 8
   static std::shared_ptr<rocksdb::Cache> block_cache_compressed;
 #endif
+
+  // lock timeouts, deadlocks and failed validation are retryable conflicts
+  bool IsConflict(const rocksdb::Status &s) {
+    return s.IsBusy() || s.IsTimedOut() || s.IsTryAgain();
+  }
+
+  // records flushes, compactions and write stalls on the event timeline
+  class TimelineListener : public rocksdb::EventListener {
+   public:
+    void OnFlushBegin(rocksdb::DB *, const rocksdb::FlushJobInfo &info) override {
+      Begin("flush/" + std::to_string(info.job_id));
+    }
+    void OnFlushCompleted(rocksdb::DB *, const rocksdb::FlushJobInfo &info) override {
+      uint64_t start;
+      if (End("flush/" + std::to_string(info.job_id), &start)) {
+        ycsbc::EventTimeline::Complete("flush", "rocksdb", ycsbc::EventTimeline::kEngine, info.thread_id,
+                                       start, ycsbc::EventTimeline::Now() - start,
+                                       ycsbc::EventTimeline::Args({
+                                         {"cf", info.cf_name},
+                                         {"file", info.file_path},
+                                         {"slowdown", info.triggered_writes_slowdown ? "true" : "false"},
+                                         {"stop", info.triggered_writes_stop ? "true" : "false"},
+                                       }));
+      }
+    }
+    void OnCompactionBegin(rocksdb::DB *, const rocksdb::CompactionJobInfo &info) override {
+      Begin("compaction/" + std::to_string(info.job_id));
+    }
+    void OnCompactionCompleted(rocksdb::DB *, const rocksdb::CompactionJobInfo &info) override {
+      uint64_t start;
+      if (End("compaction/" + std::to_string(info.job_id), &start)) {
+        ycsbc::EventTimeline::Complete("compaction L" + std::to_string(info.base_input_level) + "->L" +
+                                         std::to_string(info.output_level),
+                                       "rocksdb", ycsbc::EventTimeline::kEngine, info.thread_id,
+                                       start, ycsbc::EventTimeline::Now() - start,
+                                       ycsbc::EventTimeline::Args({
+                                         {"cf", info.cf_name},
+                                         {"input_bytes", std::to_string(info.stats.total_input_bytes)},
+                                         {"output_bytes", std::to_string(info.stats.total_output_bytes)},
+                                         {"status", info.status.ToString()},
+                                       }));
+      }
+    }
+    void OnStallConditionsChanged(const rocksdb::WriteStallInfo &info) override {
+      // a stall lasts until the condition changes, and may turn from delayed to stopped
+      const std::string key = "stall/" + info.cf_name;
+      uint64_t start;
+      if (info.condition.prev != rocksdb::WriteStallCondition::kNormal && End(key, &start)) {
+        const bool stopped = info.condition.prev == rocksdb::WriteStallCondition::kStopped;
+        ycsbc::EventTimeline::Complete(stopped ? "write stall (stopped)" : "write stall (delayed)",
+                                       "rocksdb", ycsbc::EventTimeline::kEngine, 0,
+                                       start, ycsbc::EventTimeline::Now() - start,
+                                       ycsbc::EventTimeline::Args({{"cf", info.cf_name}}));
+      }
+      if (info.condition.cur != rocksdb::WriteStallCondition::kNormal) {
+        Begin(key);
+      }
+    }
+
+   private:
+    void Begin(const std::string &key) {
+      std::lock_guard<std::mutex> lock(mu_);
+      started_[key] = ycsbc::EventTimeline::Now();
+    }
+    bool End(const std::string &key, uint64_t *start) {
+      std::lock_guard<std::mutex> lock(mu_);
+      auto it = started_.find(key);
+      if (it == started_.end()) {
+        return false;
+      }
+      *start = it->second;
+      started_.erase(it);
+      return true;
+    }
+
+    std::mutex mu_;
+    std::map<std::string, uint64_t> started_;
+  };
 } // anonymous
 
 namespace ycsbc {
 
 std::vector<rocksdb::ColumnFamilyHandle *> RocksdbDB::cf_handles_;
+std::unordered_map<std::string, rocksdb::ColumnFamilyHandle *> RocksdbDB::table_cfs_;
 rocksdb::DB *RocksdbDB::db_ = nullptr;
+rocksdb::TransactionDB *RocksdbDB::txn_db_ = nullptr;
+rocksdb::OptimisticTransactionDB *RocksdbDB::optimistic_db_ = nullptr;
 int RocksdbDB::ref_cnt_ = 0;
 std::mutex RocksdbDB::mu_;
 
@@ -180,9 +279,6 @@ void RocksdbDB::Init() {
   } else {
     throw utils::Exception("unknown format");
   }
-  fieldcount_ = std::stoi(props.GetProperty(CoreWorkload::FIELD_COUNT_PROPERTY,
-                                            CoreWorkload::FIELD_COUNT_DEFAULT));
-
   ref_cnt_++;
   if (db_) {
     return;
@@ -200,6 +296,13 @@ void RocksdbDB::Init() {
 #ifdef USE_MERGEUPDATE
   opt.merge_operator.reset(new YCSBUpdateMerge);
 #endif
+  // column families created for tables take the options of the default one
+  rocksdb::ColumnFamilyOptions cf_opt(opt);
+  for (const rocksdb::ColumnFamilyDescriptor &desc : cf_descs) {
+    if (desc.name == rocksdb::kDefaultColumnFamilyName) {
+      cf_opt = desc.options;
+    }
+  }
 
   rocksdb::Status s;
   if (props.GetProperty(PROP_DESTROY, PROP_DESTROY_DEFAULT) == "true") {
@@ -209,13 +312,91 @@ void RocksdbDB::Init() {
     }
   }
   if (cf_descs.empty()) {
-    s = rocksdb::DB::Open(opt, db_path, &db_);
+    // a database loaded with tables has column families, which must all be opened
+    std::vector<std::string> cf_names;
+    s = rocksdb::DB::ListColumnFamilies(opt, db_path, &cf_names);
+    if (s.ok() && cf_names.size() > 1) {
+      for (const std::string &name : cf_names) {
+        cf_descs.emplace_back(name, cf_opt);
+      }
+    }
+  }
+  // the lost-update check needs read-modify-writes that run in a transaction
+  const bool lost_update_check = props.GetProperty(CoreWorkload::LOST_UPDATE_CHECK_PROPERTY,
+                                                   CoreWorkload::LOST_UPDATE_CHECK_DEFAULT) == "true";
+  const std::string txn = props.GetProperty(PROP_TRANSACTION,
+                                            lost_update_check ? "optimistic" : PROP_TRANSACTION_DEFAULT);
+  if (lost_update_check && txn == "none") {
+    std::cerr << "WARNING: " << PROP_TRANSACTION << "=none runs read-modify-writes as a read then an update, "
+              << "so " << CoreWorkload::LOST_UPDATE_CHECK_PROPERTY << " will report the updates lost "
+              << "between them" << std::endl;
+  }
+  if (txn == "pessimistic") {
+    rocksdb::TransactionDBOptions txn_db_opt;
+    if (cf_descs.empty()) {
+      s = rocksdb::TransactionDB::Open(opt, txn_db_opt, db_path, &txn_db_);
+    } else {
+      s = rocksdb::TransactionDB::Open(opt, txn_db_opt, db_path, cf_descs, &cf_handles_, &txn_db_);
+    }
+    db_ = txn_db_;
+  } else if (txn == "optimistic") {
+    if (cf_descs.empty()) {
+      s = rocksdb::OptimisticTransactionDB::Open(opt, db_path, &optimistic_db_);
+    } else {
+      s = rocksdb::OptimisticTransactionDB::Open(opt, db_path, cf_descs, &cf_handles_, &optimistic_db_);
+    }
+    db_ = optimistic_db_;
+  } else if (txn == "none") {
+    if (cf_descs.empty()) {
+      s = rocksdb::DB::Open(opt, db_path, &db_);
+    } else {
+      s = rocksdb::DB::Open(opt, db_path, cf_descs, &cf_handles_, &db_);
+    }
   } else {
-    s = rocksdb::DB::Open(opt, db_path, cf_descs, &cf_handles_, &db_);
+    throw utils::Exception("unknown " + PROP_TRANSACTION + ": " + txn);
   }
   if (!s.ok()) {
     throw utils::Exception(std::string("RocksDB Open: ") + s.ToString());
   }
+  OpenTables(props, cf_opt);
+}
+
+void RocksdbDB::OpenTables(const utils::Properties &props, const rocksdb::ColumnFamilyOptions &cf_opt) {
+  // a single table stays in the default column family
+  if (props.GetProperty(CoreWorkload::TABLES_PROPERTY).empty()) {
+    table_cfs_[CoreWorkload::GetTableNames(props)[0]] = db_->DefaultColumnFamily();
+    return;
+  }
+  // the tables share the block cache, the write buffer budget and the background threads
+  for (const std::string &table : CoreWorkload::GetTableNames(props)) {
+    rocksdb::ColumnFamilyHandle *cf = nullptr;
+    for (rocksdb::ColumnFamilyHandle *handle : cf_handles_) {
+      if (handle->GetName() == table) {
+        cf = handle;
+        break;
+      }
+    }
+    if (cf == nullptr) {
+      rocksdb::Status s = db_->CreateColumnFamily(cf_opt, table, &cf);
+      if (!s.ok()) {
+        throw utils::Exception(std::string("RocksDB CreateColumnFamily: ") + s.ToString());
+      }
+      cf_handles_.push_back(cf);
+    }
+    table_cfs_[table] = cf;
+  }
+}
+
+rocksdb::ColumnFamilyHandle *RocksdbDB::ColumnFamily(const std::string &table) {
+  // with a single table, any table name maps to it as before
+  if (table_cfs_.size() == 1) {
+    return table_cfs_.begin()->second;
+  }
+  auto it = table_cfs_.find(table);
+  if (it == table_cfs_.end()) {
+    throw utils::Exception("RocksDB unknown table: " + table);
+  }
+  return it->second;
 }
 
 void RocksdbDB::Cleanup() { 
@@ -223,6 +404,7 @@ void RocksdbDB::Cleanup() {
   if (--ref_cnt_) {
     return;
   }
+  table_cfs_.clear();
   for (size_t i = 0; i < cf_handles_.size(); i++) {
     if (cf_handles_[i] != nullptr) {
       delete cf_handles_[i];
@@ -230,6 +412,9 @@ void RocksdbDB::Cleanup() {
     }
   }
   delete db_;
+  db_ = nullptr;
+  txn_db_ = nullptr;
+  optimistic_db_ = nullptr;
 }
 
 void RocksdbDB::GetOptions(const utils::Properties &props, rocksdb::Options *opt,
@@ -365,6 +550,14 @@ void RocksdbDB::GetOptions(const utils::Properties &props, rocksdb::Options *opt
       opt->OptimizeLevelStyleCompaction();
     }
   }
+
+  // tickers for GetStats, at some cost on every operation
+  if (props.GetProperty(PROP_STATISTICS, PROP_STATISTICS_DEFAULT) == "true") {
+    opt->statistics = rocksdb::CreateDBStatistics();
+  }
+  if (EventTimeline::Enabled()) {
+    opt->listeners.push_back(std::make_shared<TimelineListener>());
+  }
 }
 
 void RocksdbDB::SerializeRow(const std::vector<Field> &values, std::string &data) {
@@ -431,7 +624,7 @@ DB::Status RocksdbDB::ReadSingle(const std::string &table, const std::string &ke
                                  const std::vector<std::string> *fields,
                                  std::vector<Field> &result) {
   std::string data;
-  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), key, &data);
+  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), ColumnFamily(table), key, &data);
   if (s.IsNotFound()) {
     return kNotFound;
   } else if (!s.ok()) {
@@ -441,7 +634,6 @@ DB::Status RocksdbDB::ReadSingle(const std::string &table, const std::string &ke
     DeserializeRowFilter(result, data, *fields);
   } else {
     DeserializeRow(result, data);
-    assert(result.size() == static_cast<size_t>(fieldcount_));
   }
   return kOK;
 }
@@ -449,7 +641,7 @@ DB::Status RocksdbDB::ReadSingle(const std::string &table, const std::string &ke
 DB::Status RocksdbDB::ScanSingle(const std::string &table, const std::string &key, int len,
                                  const std::vector<std::string> *fields,
                                  std::vector<std::vector<Field>> &result) {
-  rocksdb::Iterator *db_iter = db_->NewIterator(rocksdb::ReadOptions());
+  rocksdb::Iterator *db_iter = db_->NewIterator(rocksdb::ReadOptions(), ColumnFamily(table));
   db_iter->Seek(key);
   for (int i = 0; db_iter->Valid() && i < len; i++) {
     std::string data = db_iter->value().ToString();
@@ -459,7 +651,6 @@ DB::Status RocksdbDB::ScanSingle(const std::string &table, const std::string &ke
       DeserializeRowFilter(values, data, *fields);
     } else {
       DeserializeRow(values, data);
-      assert(values.size() == static_cast<size_t>(fieldcount_));
     }
     db_iter->Next();
   }
@@ -470,7 +661,7 @@ DB::Status RocksdbDB::ScanSingle(const std::string &table, const std::string &ke
 DB::Status RocksdbDB::UpdateSingle(const std::string &table, const std::string &key,
                                    std::vector<Field> &values) {
   std::string data;
-  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), key, &data);
+  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), ColumnFamily(table), key, &data);
   if (s.IsNotFound()) {
     return kNotFound;
   } else if (!s.ok()) {
@@ -478,7 +669,6 @@ DB::Status RocksdbDB::UpdateSingle(const std::string &table, const std::string &
   }
   std::vector<Field> current_values;
   DeserializeRow(current_values, data);
-  assert(current_values.size() == static_cast<size_t>(fieldcount_));
   for (Field &new_field : values) {
     bool found MAYBE_UNUSED = false;
     for (Field &cur_field : current_values) {
@@ -494,7 +684,7 @@ DB::Status RocksdbDB::UpdateSingle(const std::string &table, const std::string &
 
   data.clear();
   SerializeRow(current_values, data);
-  s = db_->Put(wopt, key, data);
+  s = db_->Put(wopt, ColumnFamily(table), key, data);
   if (!s.ok()) {
     throw utils::Exception(std::string("RocksDB Put: ") + s.ToString());
   }
@@ -506,7 +696,7 @@ DB::Status RocksdbDB::MergeSingle(const std::string &table, const std::string &k
   std::string data;
   SerializeRow(values, data);
   rocksdb::WriteOptions wopt;
-  rocksdb::Status s = db_->Merge(wopt, key, data);
+  rocksdb::Status s = db_->Merge(wopt, ColumnFamily(table), key, data);
   if (!s.ok()) {
     throw utils::Exception(std::string("RocksDB Merge: ") + s.ToString());
   }
@@ -518,7 +708,7 @@ DB::Status RocksdbDB::InsertSingle(const std::string &table, const std::string &
   std::string data;
   SerializeRow(values, data);
   rocksdb::WriteOptions wopt;
-  rocksdb::Status s = db_->Put(wopt, key, data);
+  rocksdb::Status s = db_->Put(wopt, ColumnFamily(table), key, data);
   if (!s.ok()) {
     throw utils::Exception(std::string("RocksDB Put: ") + s.ToString());
   }
@@ -527,13 +717,256 @@ DB::Status RocksdbDB::InsertSingle(const std::string &table, const std::string &
 
 DB::Status RocksdbDB::DeleteSingle(const std::string &table, const std::string &key) {
   rocksdb::WriteOptions wopt;
-  rocksdb::Status s = db_->Delete(wopt, key);
+  rocksdb::Status s = db_->Delete(wopt, ColumnFamily(table), key);
   if (!s.ok()) {
     throw utils::Exception(std::string("RocksDB Delete: ") + s.ToString());
   }
   return kOK;
 }
 
+DB::Status RocksdbDB::ScanAll(const std::string &table, const ScanVisitor &visit) {
+  // the iterator pins the memtables and SST files it started with until it is deleted
+  rocksdb::Iterator *db_iter = db_->NewIterator(rocksdb::ReadOptions(), ColumnFamily(table));
+  for (db_iter->SeekToFirst(); db_iter->Valid(); db_iter->Next()) {
+    if (!visit(db_iter->key().size() + db_iter->value().size())) {
+      break;
+    }
+  }
+  rocksdb::Status s = db_iter->status();
+  delete db_iter;
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB ScanAll: ") + s.ToString());
+  }
+  return kOK;
+}
+
+DB::Status RocksdbDB::BatchWrite(const std::string &table, std::vector<Mutation> &batch) {
+  rocksdb::ColumnFamilyHandle *cf = ColumnFamily(table);
+  rocksdb::WriteBatch wb;
+  std::string data;
+  for (Mutation &m : batch) {
+    if (m.type == Mutation::kInsert) {
+      data.clear();
+      SerializeRow(m.values, data);
+      wb.Put(cf, m.key, data);
+    } else {
+      wb.Delete(cf, m.key);
+    }
+  }
+  rocksdb::WriteOptions wopt;
+  rocksdb::Status s = db_->Write(wopt, &wb);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB Write: ") + s.ToString());
+  }
+  return kOK;
+}
+
+class RocksdbDB::RocksdbTransaction : public DB::Transaction {
+ public:
+  RocksdbTransaction(rocksdb::Transaction *txn, rocksdb::ColumnFamilyHandle *cf) : txn_(txn), cf_(cf) {}
+  ~RocksdbTransaction() { delete txn_; }
+
+  Status Read(const std::string &key, const std::vector<std::string> *fields,
+              std::vector<Field> &result) {
+    std::string data;
+    rocksdb::Status s = txn_->GetForUpdate(rocksdb::ReadOptions(), cf_, key, &data);
+    if (s.IsNotFound()) {
+      return kNotFound;
+    } else if (IsConflict(s)) {
+      return kAborted;
+    } else if (!s.ok()) {
+      throw utils::Exception(std::string("RocksDB GetForUpdate: ") + s.ToString());
+    }
+    if (fields != nullptr) {
+      DeserializeRowFilter(result, data, *fields);
+    } else {
+      DeserializeRow(result, data);
+    }
+    return kOK;
+  }
+
+  Status Write(const std::string &key, std::vector<Field> &values) {
+    std::string data;
+    SerializeRow(values, data);
+    rocksdb::Status s = txn_->Put(cf_, key, data);
+    if (IsConflict(s)) {
+      return kAborted;
+    } else if (!s.ok()) {
+      throw utils::Exception(std::string("RocksDB Transaction Put: ") + s.ToString());
+    }
+    return kOK;
+  }
+
+  Status Commit() {
+    rocksdb::Status s = txn_->Commit();
+    if (IsConflict(s)) {
+      return kAborted;
+    } else if (!s.ok()) {
+      throw utils::Exception(std::string("RocksDB Commit: ") + s.ToString());
+    }
+    return kOK;
+  }
+
+  void Rollback() {
+    txn_->Rollback();
+  }
+
+ private:
+  rocksdb::Transaction *txn_;
+  rocksdb::ColumnFamilyHandle *cf_;
+};
+
+DB::Transaction *RocksdbDB::BeginTransaction(const std::string &table) {
+  rocksdb::WriteOptions wopt;
+  if (txn_db_ != nullptr) {
+    rocksdb::TransactionOptions txn_opt;
+    txn_opt.deadlock_detect = true;
+    return new RocksdbTransaction(txn_db_->BeginTransaction(wopt, txn_opt), ColumnFamily(table));
+  } else if (optimistic_db_ != nullptr) {
+    return new RocksdbTransaction(optimistic_db_->BeginTransaction(wopt), ColumnFamily(table));
+  }
+  return nullptr;
+}
+
+DB::Status RocksdbDB::Checkpoint(const std::string &dir) {
+  rocksdb::Checkpoint *checkpoint;
+  rocksdb::Status s = rocksdb::Checkpoint::Create(db_, &checkpoint);
+  if (s.ok()) {
+    s = checkpoint->CreateCheckpoint(dir);
+    delete checkpoint;
+  }
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB Checkpoint: ") + s.ToString());
+  }
+  return kOK;
+}
+
+DB::Status RocksdbDB::Restore(const std::string &dir) {
+  const std::lock_guard<std::mutex> lock(mu_);
+  if (db_) {
+    throw utils::Exception("RocksDB Restore: the database is open");
+  }
+  const std::string db_path = props_->GetProperty(PROP_NAME, PROP_NAME_DEFAULT);
+  if (db_path == "") {
+    throw utils::Exception("RocksDB db path is missing");
+  }
+  utils::ClearDirectory(db_path);
+  utils::MakeDirectory(db_path);
+  for (const std::string &file : utils::ListFiles(dir)) {
+    // SST files never change, the WAL and MANIFEST are appended to
+    const bool immutable = file.size() > 4 && file.compare(file.size() - 4, 4, ".sst") == 0;
+    if (immutable) {
+      utils::LinkOrCopyFile(dir + "/" + file, db_path + "/" + file);
+    } else {
+      utils::CopyFile(dir + "/" + file, db_path + "/" + file);
+    }
+  }
+  return kOK;
+}
+
+DB::Status RocksdbDB::BulkLoad(const std::string &table, const std::vector<std::string> &files) {
+  rocksdb::ColumnFamilyHandle *cf = ColumnFamily(table);
+  const rocksdb::Options opt = db_->GetOptions(cf);
+
+  // build one SST file per partition in parallel, next to the partition
+  std::vector<std::string> ssts(files.size());
+  std::vector<std::future<rocksdb::Status>> writers;
+  for (size_t i = 0; i < files.size(); i++) {
+    ssts[i] = files[i] + ".sst";
+    writers.emplace_back(std::async(std::launch::async, [&, i]() {
+      BulkFileReader reader;
+      reader.Open(files[i]);
+      rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), opt, cf);
+      rocksdb::Status s = writer.Open(ssts[i]);
+      std::string key;
+      std::vector<Field> values;
+      std::string data;
+      while (s.ok() && reader.Next(key, values)) {
+        data.clear();
+        SerializeRow(values, data);
+        s = writer.Put(key, data);
+      }
+      if (s.ok() && writer.FileSize() > 0) {
+        s = writer.Finish();
+      } else if (s.ok()) {
+        ssts[i].clear(); // an empty partition has nothing to ingest
+      }
+      return s;
+    }));
+  }
+  std::vector<std::string> ingest;
+  for (size_t i = 0; i < files.size(); i++) {
+    rocksdb::Status s = writers[i].get();
+    if (!s.ok()) {
+      throw utils::Exception(std::string("RocksDB SstFileWriter: ") + s.ToString());
+    }
+    if (!ssts[i].empty()) {
+      ingest.push_back(ssts[i]);
+    }
+  }
+
+  if (ingest.empty()) {
+    return kOK;
+  }
+
+  // the files do not overlap, so they go straight to the bottom level
+  rocksdb::IngestExternalFileOptions ingest_opt;
+  ingest_opt.move_files = true;
+  rocksdb::Status s = db_->IngestExternalFile(cf, ingest, ingest_opt);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB IngestExternalFile: ") + s.ToString());
+  }
+  return kOK;
+}
+
+std::vector<std::string> RocksdbDB::GetDataPaths() {
+  return {props_->GetProperty(PROP_NAME, PROP_NAME_DEFAULT)};
+}
+
+DB::Status RocksdbDB::GetStats(std::vector<Field> &stats) {
+  const std::lock_guard<std::mutex> lock(mu_);
+  if (db_ == nullptr) {
+    return kError;
+  }
+  // gauges of the default column family
+  for (const char *name : {"rocksdb.num-files-at-level0", "rocksdb.num-immutable-mem-table",
+                           "rocksdb.cur-size-all-mem-tables", "rocksdb.estimate-pending-compaction-bytes",
+                           "rocksdb.num-running-flushes", "rocksdb.num-running-compactions",
+                           "rocksdb.actual-delayed-write-rate", "rocksdb.is-write-stopped",
+                           "rocksdb.block-cache-usage"}) {
+    uint64_t value;
+    if (db_->GetIntProperty(name, &value)) {
+      stats.push_back({name, std::to_string(value)});
+    }
+  }
+  // write stall counters, the structured form of the stall lines of rocksdb.stats
+  std::map<std::string, std::string> cf_stats;
+  if (db_->GetMapProperty(rocksdb::DB::Properties::kCFStats, &cf_stats)) {
+    for (const auto &stat : cf_stats) {
+      if (stat.first.compare(0, 10, "io_stalls.") == 0) {
+        stats.push_back({"rocksdb." + stat.first, stat.second});
+      }
+    }
+  }
+  std::shared_ptr<rocksdb::Statistics> statistics = db_->GetDBOptions().statistics;
+  if (statistics) {
+    const std::pair<rocksdb::Tickers, const char *> tickers[] = {
+      {rocksdb::STALL_MICROS, "rocksdb.stall.micros"},
+      {rocksdb::BLOCK_CACHE_HIT, "rocksdb.block.cache.hit"},
+      {rocksdb::BLOCK_CACHE_MISS, "rocksdb.block.cache.miss"},
+      {rocksdb::BYTES_WRITTEN, "rocksdb.bytes.written"},
+      {rocksdb::WAL_FILE_BYTES, "rocksdb.wal.bytes"},
+      {rocksdb::FLUSH_WRITE_BYTES, "rocksdb.flush.write.bytes"},
+      {rocksdb::COMPACT_READ_BYTES, "rocksdb.compact.read.bytes"},
+      {rocksdb::COMPACT_WRITE_BYTES, "rocksdb.compact.write.bytes"},
+    };
+    for (const auto &ticker : tickers) {
+      stats.push_back({ticker.second, std::to_string(statistics->getTickerCount(ticker.first))});
+    }
+  }
+  return kOK;
+}
+
 DB *NewRocksdbDB() {
   return new RocksdbDB;
 }
@@ -10,12 +10,15 @@
 
 #include <string>
 #include <mutex>
+#include <unordered_map>
 
 #include "core/db.h"
 #include "utils/properties.h"
 
 #include <rocksdb/db.h>
 #include <rocksdb/options.h>
+#include <rocksdb/utilities/optimistic_transaction_db.h>
+#include <rocksdb/utilities/transaction_db.h>
 
 namespace ycsbc {
 
@@ -50,7 +53,25 @@ class RocksdbDB : public DB {
     return (this->*(method_delete_))(table, key);
   }
 
+  Status ScanAll(const std::string &table, const ScanVisitor &visit);
+
+  Status BatchWrite(const std::string &table, std::vector<Mutation> &batch);
+
+  Transaction *BeginTransaction(const std::string &table);
+
+  Status Checkpoint(const std::string &dir);
+
+  Status Restore(const std::string &dir);
+
+  Status BulkLoad(const std::string &table, const std::vector<std::string> &files);
+
+  std::vector<std::string> GetDataPaths();
+
+  Status GetStats(std::vector<Field> &stats);
+
  private:
+  class RocksdbTransaction;
+
   enum RocksFormat {
     kSingleRow,
   };
@@ -58,6 +79,8 @@ class RocksdbDB : public DB {
 
   void GetOptions(const utils::Properties &props, rocksdb::Options *opt,
                   std::vector<rocksdb::ColumnFamilyDescriptor> *cf_descs);
+  void OpenTables(const utils::Properties &props, const rocksdb::ColumnFamilyOptions &cf_opt);
+  static rocksdb::ColumnFamilyHandle *ColumnFamily(const std::string &table);
   static void SerializeRow(const std::vector<Field> &values, std::string &data);
   static void DeserializeRowFilter(std::vector<Field> &values, const char *p, const char *lim,
                                    const std::vector<std::string> &fields);
@@ -90,10 +113,13 @@ class RocksdbDB : public DB {
                                       std::vector<Field> &);
   Status (RocksdbDB::*method_delete_)(const std::string &, const std::string &);
 
-  int fieldcount_;
-
   static std::vector<rocksdb::ColumnFamilyHandle *> cf_handles_;
+  // column family of each table
+  static std::unordered_map<std::string, rocksdb::ColumnFamilyHandle *> table_cfs_;
   static rocksdb::DB *db_;
+  // set when db_ was opened for transactions, db_ then points to the same object
+  static rocksdb::TransactionDB *txn_db_;
+  static rocksdb::OptimisticTransactionDB *optimistic_db_;
   static int ref_cnt_;
   static std::mutex mu_;
 };
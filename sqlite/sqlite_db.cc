@@ -6,12 +6,16 @@
 //
 
 #include "query_builder.h"
+#include "core/bulk_file.h"
 #include "core/db_factory.h"
+#include "utils/files.h"
 #include "utils/properties.h"
 #include "utils/utils.h"
 
 #include "sqlite_db.h"
 
+#include <algorithm>
+
 namespace {
 
 const std::string PROP_DBPATH = "sqlite.dbpath";
@@ -35,6 +39,12 @@ const std::string PROP_PRIMARY_KEY_DEFAULT = "user_id";
 const std::string PROP_CREATE_TABLE = "sqlite.create_table";
 const std::string PROP_CREATE_TABLE_DEFAULT = "true";
 
+const std::string PROP_BUSY_TIMEOUT = "sqlite.busy_timeout";
+const std::string PROP_BUSY_TIMEOUT_DEFAULT = "10000";
+
+// name of the database file in a checkpoint directory
+const std::string kCheckpointFile = "sqlite.db";
+
 static sqlite3_stmt *SQLite3Prepare(sqlite3 *db, std::string query) {
   sqlite3_stmt *stmt;
   int rc = sqlite3_prepare_v2(db, query.c_str(), query.size()+1, &stmt, nullptr);
@@ -53,9 +63,7 @@ int SqliteDB::ref_cnt_ = 0;
 std::mutex SqliteDB::mu_;
 
 std::string SqliteDB::key_;
-std::string SqliteDB::field_prefix_;
-size_t SqliteDB::field_count_;
-std::string SqliteDB::table_name_;
+std::unordered_map<std::string, std::vector<std::string>> SqliteDB::table_fields_;
 
 void SqliteDB::Init() {
   const std::lock_guard<std::mutex> lock(mu_);
@@ -67,7 +75,9 @@ void SqliteDB::Init() {
   }
 
   // per-thread init
-  PrepareQueries();
+  for (auto &table : table_fields_) {
+    PrepareQueries(table.first, tables_[table.first]);
+  }
 }
 
 void SqliteDB::OpenDB() {
@@ -82,19 +92,26 @@ void SqliteDB::OpenDB() {
   }
 
   key_ = props_->GetProperty(PROP_PRIMARY_KEY, PROP_PRIMARY_KEY_DEFAULT);
-  field_prefix_ = props_->GetProperty(CoreWorkload::FIELD_NAME_PREFIX, CoreWorkload::FIELD_NAME_PREFIX_DEFAULT);
-  field_count_ = std::stoi(props_->GetProperty(CoreWorkload::FIELD_COUNT_PROPERTY, CoreWorkload::FIELD_COUNT_DEFAULT));
-  table_name_ = props_->GetProperty(CoreWorkload::TABLENAME_DEFAULT, CoreWorkload::TABLENAME_DEFAULT);
 
-  if (props_->GetProperty(PROP_CREATE_TABLE, PROP_CREATE_TABLE_DEFAULT) == "true") {
-    std::vector<std::string> fields;
-    fields.reserve(field_count_);
-    for (size_t i = 0; i < field_count_; i++) {
-        fields.push_back(field_prefix_ + std::to_string(i));
+  // each table has the field schema of its own properties
+  table_fields_.clear();
+  for (std::string table : CoreWorkload::GetTableNames(*props_)) {
+    const utils::Properties p = CoreWorkload::GetTableProperties(*props_, table);
+    const std::string field_prefix = p.GetProperty(CoreWorkload::FIELD_NAME_PREFIX,
+                                                   CoreWorkload::FIELD_NAME_PREFIX_DEFAULT);
+    const size_t field_count = std::stoi(p.GetProperty(CoreWorkload::FIELD_COUNT_PROPERTY,
+                                                       CoreWorkload::FIELD_COUNT_DEFAULT));
+    std::vector<std::string> &fields = table_fields_[table];
+    fields.reserve(field_count);
+    for (size_t i = 0; i < field_count; i++) {
+        fields.push_back(field_prefix + std::to_string(i));
     }
-    rc = sqlite3_exec(db_, BuildCreateTableQuery(table_name_, key_, fields).c_str(), nullptr, nullptr, nullptr);
-    if (rc != SQLITE_OK) {
-      throw utils::Exception(std::string("Create table: ") + sqlite3_errmsg(db_));
+
+    if (props_->GetProperty(PROP_CREATE_TABLE, PROP_CREATE_TABLE_DEFAULT) == "true") {
+      rc = sqlite3_exec(db_, BuildCreateTableQuery(table, key_, fields).c_str(), nullptr, nullptr, nullptr);
+      if (rc != SQLITE_OK) {
+        throw utils::Exception(std::string("Create table: ") + sqlite3_errmsg(db_));
+      }
     }
   }
 }
@@ -121,6 +138,9 @@ void SqliteDB::SetPragma() {
     throw utils::Exception(std::string("Init exec journal_mode: ") + sqlite3_errmsg(db_));
   }
 
+  // transactions run on per-thread connections, so the shared one may find the database locked
+  sqlite3_busy_timeout(db_, std::stoi(props_->GetProperty(PROP_BUSY_TIMEOUT, PROP_BUSY_TIMEOUT_DEFAULT)));
+
   std::string synchronous = props_->GetProperty(PROP_SYNCHRONOUS, PROP_SYNCHRONOUS_DEFAULT);
   stmt = std::string("PRAGMA synchronous = ") + synchronous;
   rc = sqlite3_exec(db_, stmt.c_str(), nullptr, nullptr, nullptr);
@@ -129,62 +149,82 @@ void SqliteDB::SetPragma() {
   }
 }
 
-void SqliteDB::PrepareQueries() {
-  std::vector<std::string> fields;
-  fields.reserve(field_count_);
-  for (size_t i = 0; i < field_count_; i++) {
-      fields.push_back(field_prefix_ + std::to_string(i));
-  }
+void SqliteDB::PrepareQueries(const std::string &table, TableStatements &stmts) {
+  const std::vector<std::string> &fields = table_fields_.at(table);
+  stmts.name = table;
+  stmts.field_count = fields.size();
+  stmts.txn_read = nullptr;
+  stmts.txn_write = nullptr;
 
   // Read
-  stmt_read_all_ = SQLite3Prepare(db_, BuildReadQuery(table_name_, key_, fields));
-  for (size_t i = 0; i < field_count_; i++) {
-    std::string field_name = field_prefix_ + std::to_string(i);
-    stmt_read_field_[field_name] = SQLite3Prepare(db_, BuildReadQuery(table_name_, key_, {field_name}));
+  stmts.read_all = SQLite3Prepare(db_, BuildReadQuery(stmts.name, key_, fields));
+  for (const std::string &field_name : fields) {
+    stmts.read_field[field_name] = SQLite3Prepare(db_, BuildReadQuery(stmts.name, key_, {field_name}));
   }
 
   // Scan
-  stmt_scan_all_ = SQLite3Prepare(db_, BuildScanQuery(table_name_, key_, fields));
-  for (size_t i = 0; i < field_count_; i++) {
-    std::string field_name = field_prefix_ + std::to_string(i);
-    stmt_scan_field_[field_name] = SQLite3Prepare(db_, BuildScanQuery(table_name_, key_, {field_name}));
+  stmts.scan_all = SQLite3Prepare(db_, BuildScanQuery(stmts.name, key_, fields));
+  for (const std::string &field_name : fields) {
+    stmts.scan_field[field_name] = SQLite3Prepare(db_, BuildScanQuery(stmts.name, key_, {field_name}));
   }
 
   // Update
-  stmt_update_all_ = SQLite3Prepare(db_, BuildUpdateQuery(table_name_, key_, fields));
-  for (size_t i = 0; i < field_count_; i++) {
-    std::string field_name = field_prefix_ + std::to_string(i);
-    stmt_update_field_[field_name] = SQLite3Prepare(db_, BuildUpdateQuery(table_name_, key_, {field_name}));
+  stmts.update_all = SQLite3Prepare(db_, BuildUpdateQuery(stmts.name, key_, fields));
+  for (const std::string &field_name : fields) {
+    stmts.update_field[field_name] = SQLite3Prepare(db_, BuildUpdateQuery(stmts.name, key_, {field_name}));
   }
 
   // Insert
-  stmt_insert_ = SQLite3Prepare(db_, BuildInsertQuery(table_name_, key_, fields));
+  stmts.insert = SQLite3Prepare(db_, BuildInsertQuery(stmts.name, key_, fields));
 
   // Delete
-  stmt_delete_ = SQLite3Prepare(db_, BuildDeleteQuery(table_name_, key_));
+  stmts.del = SQLite3Prepare(db_, BuildDeleteQuery(stmts.name, key_));
 }
 
-void SqliteDB::Cleanup() {
-  const std::lock_guard<std::mutex> lock(mu_);
-
-  sqlite3_finalize(stmt_read_all_);
-  for (auto s : stmt_read_field_) {
+void SqliteDB::FinalizeQueries(TableStatements &stmts) {
+  sqlite3_finalize(stmts.read_all);
+  for (auto s : stmts.read_field) {
     sqlite3_finalize(s.second);
   }
-  sqlite3_finalize(stmt_scan_all_);
-  for (auto s : stmt_scan_field_) {
+  sqlite3_finalize(stmts.scan_all);
+  for (auto s : stmts.scan_field) {
     sqlite3_finalize(s.second);
   }
-  sqlite3_finalize(stmt_update_all_);
-  for (auto s : stmt_update_field_) {
+  sqlite3_finalize(stmts.update_all);
+  for (auto s : stmts.update_field) {
     sqlite3_finalize(s.second);
   }
-  sqlite3_finalize(stmt_insert_);
-  sqlite3_finalize(stmt_delete_);
+  sqlite3_finalize(stmts.insert);
+  sqlite3_finalize(stmts.del);
+  sqlite3_finalize(stmts.txn_read);
+  sqlite3_finalize(stmts.txn_write);
+}
+
+SqliteDB::TableStatements &SqliteDB::GetTable(const std::string &table) {
+  auto it = tables_.find(table);
+  if (it == tables_.end()) {
+    throw utils::Exception("SQLite unknown table: " + table);
+  }
+  return it->second;
+}
+
+void SqliteDB::Cleanup() {
+  const std::lock_guard<std::mutex> lock(mu_);
+
+  for (auto &t : tables_) {
+    FinalizeQueries(t.second);
+  }
+  tables_.clear();
+
+  if (txn_db_ != nullptr) {
+    sqlite3_close(txn_db_);
+    txn_db_ = nullptr;
+  }
 
   if (--ref_cnt_ == 0) {
     int rc = sqlite3_close(db_);
     assert(rc == SQLITE_OK);
+    db_ = nullptr;
   }
 }
 
@@ -195,16 +235,18 @@ DB::Status SqliteDB::Read(const std::string &table, const std::string &key,
   sqlite3_stmt *stmt;
   size_t field_cnt;
 
-  if (fields == nullptr || fields->size() == field_count_) {
-    field_cnt = field_count_;
-    stmt = stmt_read_all_;
+  TableStatements &t = GetTable(table);
+
+  if (fields == nullptr || fields->size() == t.field_count) {
+    field_cnt = t.field_count;
+    stmt = t.read_all;
   } else if (fields->size() == 1) {
     field_cnt = 1;
-    stmt = stmt_read_field_[(*fields)[0]];
+    stmt = t.read_field[(*fields)[0]];
   } else {
     temp = true;
     field_cnt = fields->size();;
-    stmt = SQLite3Prepare(db_, BuildReadQuery(table_name_, key_, *fields));
+    stmt = SQLite3Prepare(db_, BuildReadQuery(t.name, key_, *fields));
   }
 
   int rc = sqlite3_bind_text(stmt, 1, key.c_str(), key.size(), SQLITE_STATIC);
@@ -243,16 +285,18 @@ DB::Status SqliteDB::Scan(const std::string &table, const std::string &key, int
   sqlite3_stmt *stmt;
   size_t field_cnt;
 
-  if (fields == nullptr || fields->size() == field_count_) {
-    field_cnt = field_count_;
-    stmt = stmt_scan_all_;
+  TableStatements &t = GetTable(table);
+
+  if (fields == nullptr || fields->size() == t.field_count) {
+    field_cnt = t.field_count;
+    stmt = t.scan_all;
   } else if (fields->size() == 1) {
     field_cnt = 1;
-    stmt = stmt_scan_field_[(*fields)[0]];
+    stmt = t.scan_field[(*fields)[0]];
   } else {
     temp = true;
     field_cnt = fields->size();;
-    stmt = SQLite3Prepare(db_, BuildScanQuery(table_name_, key_, *fields));
+    stmt = SQLite3Prepare(db_, BuildScanQuery(t.name, key_, *fields));
   }
 
   int rc = sqlite3_bind_text(stmt, 1, key.c_str(), key.size(), SQLITE_STATIC);
@@ -296,18 +340,53 @@ cleanup:
   return s;
 }
 
+DB::Status SqliteDB::ScanAll(const std::string &table, const ScanVisitor &visit) {
+  DB::Status s = kOK;
+  TableStatements &t = GetTable(table);
+  sqlite3_stmt *stmt = t.scan_all;
+
+  // the statement reads one snapshot until it is reset; a negative limit means no limit
+  int rc = sqlite3_bind_text(stmt, 1, "", 0, SQLITE_STATIC);
+  if (rc == SQLITE_OK) {
+    rc = sqlite3_bind_int(stmt, 2, -1);
+  }
+  if (rc != SQLITE_OK) {
+    s = kError;
+    goto cleanup;
+  }
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    size_t bytes = 0;
+    for (int i = 0; i <= static_cast<int>(t.field_count); i++) {
+      bytes += sqlite3_column_bytes(stmt, i);
+    }
+    if (!visit(bytes)) {
+      break;
+    }
+  }
+  if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+    s = kError;
+  }
+
+cleanup:
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  return s;
+}
+
 DB::Status SqliteDB::Update(const std::string &table, const std::string &key, std::vector<Field> &values) {
   DB::Status s = kOK;
   bool temp = false;
   sqlite3_stmt *stmt;
   size_t field_cnt;
 
-  if (values.size() == field_count_) {
-    field_cnt = field_count_;
-    stmt = stmt_update_all_;
+  TableStatements &t = GetTable(table);
+
+  if (values.size() == t.field_count) {
+    field_cnt = t.field_count;
+    stmt = t.update_all;
   } else if (values.size() == 1) {
     field_cnt = 1;
-    stmt = stmt_update_field_[values[0].name];
+    stmt = t.update_field[values[0].name];
   } else {
     temp = true;
     std::vector<std::string> fields;
@@ -316,7 +395,7 @@ DB::Status SqliteDB::Update(const std::string &table, const std::string &key, st
       fields.push_back(f.name);
     }
     field_cnt = values.size();
-    stmt = SQLite3Prepare(db_, BuildUpdateQuery(table_name_, key_, fields));
+    stmt = SQLite3Prepare(db_, BuildUpdateQuery(t.name, key_, fields));
   }
 
   int rc;
@@ -353,9 +432,10 @@ cleanup:
 
 DB::Status SqliteDB::Insert(const std::string &table, const std::string &key, std::vector<Field> &values) {
   DB::Status s = kOK;
-  sqlite3_stmt *stmt = stmt_insert_;
+  TableStatements &t = GetTable(table);
+  sqlite3_stmt *stmt = t.insert;
 
-  if (field_count_ != values.size()) {
+  if (t.field_count != values.size()) {
     return kError;
   }
 
@@ -364,7 +444,7 @@ DB::Status SqliteDB::Insert(const std::string &table, const std::string &key, st
     s = kError;
     goto cleanup;
   }
-  for (size_t i = 0; i < field_count_; i++) {
+  for (size_t i = 0; i < t.field_count; i++) {
     rc = sqlite3_bind_text(stmt, 2+i, values[i].value.c_str(), values[i].value.size(), SQLITE_STATIC);
     if (rc != SQLITE_OK) {
       s = kError;
@@ -387,7 +467,7 @@ cleanup:
 
 DB::Status SqliteDB::Delete(const std::string &table, const std::string &key) {
   DB::Status s = kOK;
-  sqlite3_stmt *stmt = stmt_delete_;
+  sqlite3_stmt *stmt = GetTable(table).del;
 
   int rc = sqlite3_bind_text(stmt, 1, key.c_str(), key.size(), SQLITE_STATIC);
   if (rc != SQLITE_OK) {
@@ -408,6 +488,240 @@ cleanup:
   return s;
 }
 
+class SqliteDB::SqliteTransaction : public DB::Transaction {
+ public:
+  // a transaction that could not take the write lock is aborted from the start
+  SqliteTransaction(SqliteDB *owner, TableStatements *table, bool aborted)
+      : owner_(owner), table_(table), aborted_(aborted) {}
+
+  Status Read(const std::string &key, const std::vector<std::string> *fields,
+              std::vector<Field> &result) {
+    if (aborted_) {
+      return kAborted;
+    }
+    DB::Status s = kOK;
+    sqlite3_stmt *stmt = table_->txn_read;
+
+    int rc = sqlite3_bind_text(stmt, 1, key.c_str(), key.size(), SQLITE_STATIC);
+    if (rc != SQLITE_OK) {
+      s = kError;
+      goto cleanup;
+    }
+
+    rc = sqlite3_step(stmt);
+    if (rc == SQLITE_BUSY) {
+      s = kAborted;
+      goto cleanup;
+    } else if (rc == SQLITE_DONE) {
+      s = kNotFound;
+      goto cleanup;
+    } else if (rc != SQLITE_ROW) {
+      s = kError;
+      goto cleanup;
+    }
+
+    result.reserve(table_->field_count);
+    for (size_t i = 0; i < table_->field_count; i++) {
+      const char *name = reinterpret_cast<const char *>(sqlite3_column_name(stmt, i));
+      if (fields != nullptr && std::find(fields->begin(), fields->end(), name) == fields->end()) {
+        continue;
+      }
+      const char *value = reinterpret_cast<const char *>(sqlite3_column_text(stmt, i));
+      result.push_back({name, value});
+    }
+
+  cleanup:
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return s;
+  }
+
+  Status Write(const std::string &key, std::vector<Field> &values) {
+    if (aborted_) {
+      return kAborted;
+    }
+    DB::Status s = kOK;
+    sqlite3_stmt *stmt = table_->txn_write;
+
+    if (table_->field_count != values.size()) {
+      return kError;
+    }
+
+    int rc = sqlite3_bind_text(stmt, 1, key.c_str(), key.size(), SQLITE_STATIC);
+    if (rc != SQLITE_OK) {
+      s = kError;
+      goto cleanup;
+    }
+    for (size_t i = 0; i < table_->field_count; i++) {
+      rc = sqlite3_bind_text(stmt, 2+i, values[i].value.c_str(), values[i].value.size(), SQLITE_STATIC);
+      if (rc != SQLITE_OK) {
+        s = kError;
+        goto cleanup;
+      }
+    }
+
+    rc = sqlite3_step(stmt);
+    if (rc == SQLITE_BUSY) {
+      s = kAborted;
+    } else if (rc != SQLITE_DONE) {
+      s = kError;
+    }
+
+  cleanup:
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return s;
+  }
+
+  Status Commit() {
+    if (aborted_) {
+      return kAborted;
+    }
+    int rc = sqlite3_exec(owner_->txn_db_, "COMMIT", nullptr, nullptr, nullptr);
+    if (rc == SQLITE_OK) {
+      return kOK;
+    }
+    // a failed commit leaves the transaction open
+    Rollback();
+    return rc == SQLITE_BUSY ? kAborted : kError;
+  }
+
+  void Rollback() {
+    if (!aborted_) {
+      sqlite3_exec(owner_->txn_db_, "ROLLBACK", nullptr, nullptr, nullptr);
+    }
+  }
+
+ private:
+  SqliteDB *owner_;
+  TableStatements *table_;
+  bool aborted_;
+};
+
+void SqliteDB::OpenTransactionConnection() {
+  const std::string &db_path = props_->GetProperty(PROP_DBPATH, PROP_DBPATH_DEFAULT);
+  int rc = sqlite3_open_v2(db_path.c_str(), &txn_db_, SQLITE_OPEN_READWRITE, nullptr);
+  if (rc != SQLITE_OK) {
+    throw utils::Exception(std::string("Transaction open: ") + sqlite3_errmsg(txn_db_));
+  }
+  // writers take turns, so wait for the write lock rather than fail
+  sqlite3_busy_timeout(txn_db_, std::stoi(props_->GetProperty(PROP_BUSY_TIMEOUT, PROP_BUSY_TIMEOUT_DEFAULT)));
+}
+
+DB::Transaction *SqliteDB::BeginTransaction(const std::string &table) {
+  if (txn_db_ == nullptr) {
+    OpenTransactionConnection();
+  }
+  TableStatements &t = GetTable(table);
+  if (t.txn_read == nullptr) {
+    const std::vector<std::string> &fields = table_fields_.at(table);
+    t.txn_read = SQLite3Prepare(txn_db_, BuildReadQuery(t.name, key_, fields));
+    t.txn_write = SQLite3Prepare(txn_db_, BuildInsertQuery(t.name, key_, fields));
+  }
+  // take the write lock up front, so that the transaction cannot deadlock later
+  int rc = sqlite3_exec(txn_db_, "BEGIN IMMEDIATE", nullptr, nullptr, nullptr);
+  if (rc == SQLITE_BUSY) {
+    return new SqliteTransaction(this, &t, true);
+  } else if (rc != SQLITE_OK) {
+    throw utils::Exception(std::string("Begin transaction: ") + sqlite3_errmsg(txn_db_));
+  }
+  return new SqliteTransaction(this, &t, false);
+}
+
+DB::Status SqliteDB::Checkpoint(const std::string &dir) {
+  utils::MakeDirectory(dir);
+  const std::string path = dir + "/" + kCheckpointFile;
+  sqlite3 *dest;
+  int rc = sqlite3_open_v2(path.c_str(), &dest, SQLITE_OPEN_READWRITE|SQLITE_OPEN_CREATE, nullptr);
+  if (rc == SQLITE_OK) {
+    // copies every page in one step, as of one read transaction
+    sqlite3_backup *backup = sqlite3_backup_init(dest, "main", db_, "main");
+    if (backup == nullptr) {
+      rc = sqlite3_errcode(dest);
+    } else {
+      rc = sqlite3_backup_step(backup, -1);
+      sqlite3_backup_finish(backup);
+    }
+  }
+  if (rc != SQLITE_DONE && rc != SQLITE_OK) {
+    std::string msg = sqlite3_errmsg(dest);
+    sqlite3_close(dest);
+    throw utils::Exception("Checkpoint backup: " + msg);
+  }
+  sqlite3_close(dest);
+  return kOK;
+}
+
+DB::Status SqliteDB::Restore(const std::string &dir) {
+  const std::lock_guard<std::mutex> lock(mu_);
+  if (db_) {
+    throw utils::Exception("SQLite Restore: the database is open");
+  }
+  const std::string &db_path = props_->GetProperty(PROP_DBPATH, PROP_DBPATH_DEFAULT);
+  if (db_path == "") {
+    throw utils::Exception("SQLite db path is missing");
+  }
+  utils::RemoveFile(db_path + "-wal");
+  utils::RemoveFile(db_path + "-shm");
+  utils::CopyFile(dir + "/" + kCheckpointFile, db_path);
+  return kOK;
+}
+
+DB::Status SqliteDB::BulkLoad(const std::string &table, const std::vector<std::string> &files) {
+  // one transaction for the whole load, with rows arriving in key order
+  int rc = sqlite3_exec(db_, "BEGIN", nullptr, nullptr, nullptr);
+  if (rc != SQLITE_OK) {
+    throw utils::Exception(std::string("BulkLoad begin: ") + sqlite3_errmsg(db_));
+  }
+  std::string key;
+  std::vector<Field> values;
+  for (const std::string &file : files) {
+    BulkFileReader reader;
+    reader.Open(file);
+    while (reader.Next(key, values)) {
+      if (Insert(table, key, values) != kOK) {
+        std::string msg = sqlite3_errmsg(db_);
+        sqlite3_exec(db_, "ROLLBACK", nullptr, nullptr, nullptr);
+        throw utils::Exception("BulkLoad insert: " + msg);
+      }
+    }
+  }
+  rc = sqlite3_exec(db_, "COMMIT", nullptr, nullptr, nullptr);
+  if (rc != SQLITE_OK) {
+    throw utils::Exception(std::string("BulkLoad commit: ") + sqlite3_errmsg(db_));
+  }
+  return kOK;
+}
+
+std::vector<std::string> SqliteDB::GetDataPaths() {
+  const std::string &db_path = props_->GetProperty(PROP_DBPATH, PROP_DBPATH_DEFAULT);
+  return {db_path, db_path + "-wal"};
+}
+
+DB::Status SqliteDB::GetStats(std::vector<Field> &stats) {
+  const std::lock_guard<std::mutex> lock(mu_);
+  if (db_ == nullptr) {
+    return kError;
+  }
+  // current values summed over the connection, hits and misses since it opened
+  const std::pair<int, const char *> counters[] = {
+    {SQLITE_DBSTATUS_CACHE_USED, "sqlite.cache_used"},
+    {SQLITE_DBSTATUS_CACHE_HIT, "sqlite.cache_hit"},
+    {SQLITE_DBSTATUS_CACHE_MISS, "sqlite.cache_miss"},
+    {SQLITE_DBSTATUS_CACHE_WRITE, "sqlite.cache_write"},
+    {SQLITE_DBSTATUS_SCHEMA_USED, "sqlite.schema_used"},
+    {SQLITE_DBSTATUS_STMT_USED, "sqlite.stmt_used"},
+  };
+  for (const auto &counter : counters) {
+    int current = 0;
+    int highwater = 0;
+    if (sqlite3_db_status(db_, counter.first, &current, &highwater, 0) == SQLITE_OK) {
+      stats.push_back({counter.second, std::to_string(current)});
+    }
+  }
+  return kOK;
+}
+
 DB *NewSqliteDB() {
   return new SqliteDB;
 }
@@ -9,7 +9,9 @@
 #define YCSB_C_SQLITE_DB_H_
 
 #include <mutex>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "core/db.h"
 
@@ -19,7 +21,7 @@ namespace ycsbc {
 
 class SqliteDB : public DB {
  public:
-  SqliteDB() {}
+  SqliteDB() : txn_db_(nullptr) {}
   ~SqliteDB() {}
 
   void Init();
@@ -32,34 +34,65 @@ class SqliteDB : public DB {
   Status Scan(const std::string &table, const std::string &key, int len,
               const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result);
 
+  Status ScanAll(const std::string &table, const ScanVisitor &visit);
+
   Status Update(const std::string &table, const std::string &key, std::vector<Field> &values);
 
   Status Insert(const std::string &table, const std::string &key, std::vector<Field> &values);
 
   Status Delete(const std::string &table, const std::string &key);
 
+  Transaction *BeginTransaction(const std::string &table);
+
+  Status Checkpoint(const std::string &dir);
+
+  Status Restore(const std::string &dir);
+
+  Status BulkLoad(const std::string &table, const std::vector<std::string> &files);
+
+  std::vector<std::string> GetDataPaths();
+
+  Status GetStats(std::vector<Field> &stats);
+
  private:
+  class SqliteTransaction;
+
+  // statements of one table, prepared per thread
+  struct TableStatements {
+    std::string name;
+    size_t field_count;
+    sqlite3_stmt *read_all;
+    sqlite3_stmt *scan_all;
+    sqlite3_stmt *update_all;
+    sqlite3_stmt *insert;
+    sqlite3_stmt *del;
+    std::unordered_map<std::string, sqlite3_stmt *> read_field;
+    std::unordered_map<std::string, sqlite3_stmt *> scan_field;
+    std::unordered_map<std::string, sqlite3_stmt *> update_field;
+    // on txn_db_, prepared by the first transaction on the table
+    sqlite3_stmt *txn_read;
+    sqlite3_stmt *txn_write;
+  };
+
   void OpenDB();
   void SetPragma();
-  void PrepareQueries();
+  void PrepareQueries(const std::string &table, TableStatements &stmts);
+  void FinalizeQueries(TableStatements &stmts);
+  TableStatements &GetTable(const std::string &table);
+  void OpenTransactionConnection();
 
   static sqlite3 *db_;
   static int ref_cnt_;
   static std::mutex mu_;
 
   static std::string key_;
-  static std::string field_prefix_;
-  static size_t field_count_;
-  static std::string table_name_;
-
-  sqlite3_stmt *stmt_read_all_;
-  sqlite3_stmt *stmt_scan_all_;
-  sqlite3_stmt *stmt_update_all_;
-  sqlite3_stmt *stmt_insert_;
-  sqlite3_stmt *stmt_delete_;
-  std::unordered_map<std::string, sqlite3_stmt *> stmt_read_field_;
-  std::unordered_map<std::string, sqlite3_stmt *> stmt_scan_field_;
-  std::unordered_map<std::string, sqlite3_stmt *> stmt_update_field_;
+  // field names of each table
+  static std::unordered_map<std::string, std::vector<std::string>> table_fields_;
+
+  std::unordered_map<std::string, TableStatements> tables_;
+
+  // transactions need a connection of their own, the shared one is used by all threads
+  sqlite3 *txn_db_;
 };
 
 DB *NewSqliteDB();
@@ -0,0 +1,241 @@
+//
+//  ycsb_gen.cc
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#include <cstring>
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "core/bulk_file.h"
+#include "core/core_workload.h"
+#include "core/measurements.h"
+#include "utils/files.h"
+#include "utils/properties.h"
+#include "utils/timer.h"
+#include "utils/utils.h"
+
+namespace {
+
+// Samples per partition for choosing the partition boundaries.
+const int kSamplesPerPartition = 256;
+
+void UsageMessage(const char *command) {
+  std::cout <<
+      "Usage: " << command << " [options]\n"
+      "Generates the load dataset of the core workload into sorted, partitioned files\n"
+      "that ycsb -load ingests with -p bulkload.dir=dir.\n"
+      "Options:\n"
+      "  -dir dir: write the dataset into dir\n"
+      "  -threads n: generate with n threads, and as many partitions unless\n"
+      "              gen.partitions is set (default: 1)\n"
+      "  -P propertyfile: load properties from the given file. Multiple files can\n"
+      "                   be specified, and will be processed in the order specified\n"
+      "  -p name=value: specify a property to be passed to the workload\n"
+      "                 multiple properties can be specified, and override any\n"
+      "                 values in the propertyfile"
+      << std::endl;
+}
+
+void ParseCommandLine(int argc, const char *argv[], ycsbc::utils::Properties &props) {
+  int argindex = 1;
+  while (argindex < argc && argv[argindex][0] == '-') {
+    const char *option = argv[argindex++];
+    if (argindex >= argc) {
+      UsageMessage(argv[0]);
+      std::cerr << "Missing argument value for " << option << std::endl;
+      exit(0);
+    }
+    const char *value = argv[argindex++];
+    if (strcmp(option, "-dir") == 0) {
+      props.SetProperty("bulkload.dir", value);
+    } else if (strcmp(option, "-threads") == 0) {
+      props.SetProperty("threadcount", value);
+    } else if (strcmp(option, "-P") == 0) {
+      std::ifstream input(value);
+      try {
+        props.Load(input);
+      } catch (const ycsbc::utils::Exception &e) {
+        std::cerr << value << ": " << e.what() << std::endl;
+        exit(0);
+      }
+    } else if (strcmp(option, "-p") == 0) {
+      std::string prop(value);
+      size_t eq = prop.find('=');
+      if (eq == std::string::npos) {
+        std::cerr << "Argument '-p' expected to be in key=value format "
+                     "(e.g., -p recordcount=99999)" << std::endl;
+        exit(0);
+      }
+      props.SetProperty(ycsbc::utils::Trim(prop.substr(0, eq)),
+                        ycsbc::utils::Trim(prop.substr(eq + 1)));
+    } else {
+      UsageMessage(argv[0]);
+      std::cerr << "Unknown option '" << option << "'" << std::endl;
+      exit(0);
+    }
+  }
+  if (argindex == 1 || argindex != argc || props.GetProperty("bulkload.dir").empty()) {
+    UsageMessage(argv[0]);
+    exit(0);
+  }
+}
+
+// Picks the keys that split the load keys into partitions of about equal
+// size, from an even sample of the key numbers.
+std::vector<std::string> PartitionBounds(ycsbc::CoreWorkload *wl, uint64_t start, uint64_t count,
+                                         int partitions) {
+  const uint64_t samples = std::min<uint64_t>(count, static_cast<uint64_t>(partitions) * kSamplesPerPartition);
+  std::vector<std::string> keys;
+  for (uint64_t i = 0; i < samples; i++) {
+    keys.push_back(wl->BuildLoadKey(start + i * count / samples));
+  }
+  std::sort(keys.begin(), keys.end());
+  std::vector<std::string> bounds;
+  for (int p = 1; p < partitions && !keys.empty(); p++) {
+    bounds.push_back(keys[p * keys.size() / partitions]);
+  }
+  return bounds;
+}
+
+typedef std::vector<std::pair<std::string, uint64_t>> PartitionKeys;
+
+// Builds the keys of records [lo, hi) and sorts those of partitions
+// [first, first + keys.size()) into keys, by the partition bounds.
+void BinKeys(ycsbc::CoreWorkload *wl, uint64_t lo, uint64_t hi, const std::vector<std::string> &bounds,
+             int first, std::vector<PartitionKeys> &keys) {
+  for (uint64_t n = lo; n < hi; n++) {
+    std::string key = wl->BuildLoadKey(n);
+    const int p = std::upper_bound(bounds.begin(), bounds.end(), key) - bounds.begin();
+    if (p >= first && p < first + static_cast<int>(keys.size())) {
+      keys[p - first].emplace_back(std::move(key), n);
+    }
+  }
+}
+
+// Writes the given records to partition i, in key order. Returns the number
+// of records.
+uint64_t WritePartition(ycsbc::CoreWorkload *wl, const std::string &dir, int i, PartitionKeys &keys) {
+  std::sort(keys.begin(), keys.end());
+
+  ycsbc::BulkFileWriter writer;
+  writer.Open(ycsbc::BulkPartitionPath(dir, i));
+  std::vector<ycsbc::DB::Field> values;
+  for (const auto &key : keys) {
+    values.clear();
+    wl->BuildLoadValues(key.second, values);
+    writer.Add(key.first, values);
+  }
+  writer.Close();
+  return keys.size();
+}
+
+} // namespace
+
+int main(const int argc, const char *argv[]) {
+  ycsbc::utils::Properties props;
+  ParseCommandLine(argc, argv, props);
+
+  const std::string dir = props["bulkload.dir"];
+  const int num_threads = std::stoi(props.GetProperty("threadcount", "1"));
+  const int partitions = std::stoi(props.GetProperty("gen.partitions", std::to_string(num_threads)));
+  if (num_threads < 1 || partitions < 1) {
+    std::cerr << "threadcount and gen.partitions must be positive" << std::endl;
+    exit(1);
+  }
+
+  ycsbc::Measurements *measurements = ycsbc::CreateMeasurements(&props);
+  ycsbc::CoreWorkload *wl = ycsbc::CreateWorkload(props, measurements);
+  if (wl == nullptr) {
+    std::cerr << "Unknown workload name " << props.GetProperty(ycsbc::CoreWorkload::WORKLOAD_PROPERTY) << std::endl;
+    exit(1);
+  }
+  wl->Init(props);
+  // other workloads build their records differently from CoreWorkload::DoInsert
+  if (typeid(*wl) != typeid(ycsbc::CoreWorkload)) {
+    std::cerr << "ycsb-gen only generates the core workload" << std::endl;
+    exit(1);
+  }
+  const uint64_t start = wl->GetLoadStart();
+  const uint64_t count = wl->GetLoadRecordCount();
+
+  ycsbc::utils::MakeDirectory(dir);
+  for (const std::string &file : ycsbc::ListBulkPartitions(dir)) {
+    ycsbc::utils::RemoveFile(file);
+  }
+
+  ycsbc::utils::Timer<double> timer;
+  timer.Start();
+  const std::vector<std::string> bounds = PartitionBounds(wl, start, count, partitions);
+
+  // the partitions are written num_threads at a time; for each round the
+  // threads split the key numbers once and bin their keys by partition, so
+  // only that round's keys are held in memory
+  const int num_partitions = bounds.size() + 1;
+  uint64_t records = 0;
+  for (int first = 0; first < num_partitions; first += num_threads) {
+    const int round = std::min(num_threads, num_partitions - first);
+    std::vector<std::vector<PartitionKeys>> bins(num_threads, std::vector<PartitionKeys>(round));
+    std::vector<std::future<void>> binners;
+    for (int t = 0; t < num_threads; t++) {
+      binners.emplace_back(std::async(std::launch::async, BinKeys, wl, start + t * count / num_threads,
+                                      start + (t + 1) * count / num_threads, std::cref(bounds), first,
+                                      std::ref(bins[t])));
+    }
+    for (auto &binner : binners) {
+      binner.get();
+    }
+
+    std::vector<std::future<uint64_t>> writers;
+    for (int r = 0; r < round; r++) {
+      writers.emplace_back(std::async(std::launch::async, [&, r]() {
+        PartitionKeys keys = std::move(bins[0][r]);
+        for (int t = 1; t < num_threads; t++) {
+          keys.insert(keys.end(), std::make_move_iterator(bins[t][r].begin()),
+                      std::make_move_iterator(bins[t][r].end()));
+          PartitionKeys().swap(bins[t][r]);
+        }
+        return WritePartition(wl, dir, first + r, keys);
+      }));
+    }
+    for (auto &writer : writers) {
+      records += writer.get();
+    }
+  }
+  const double runtime = timer.End();
+
+  // what ycsb -load checks before it ingests the dataset
+  ycsbc::utils::Properties manifest;
+  manifest.SetProperty(ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY, std::to_string(records));
+  manifest.SetProperty(ycsbc::CoreWorkload::INSERT_START_PROPERTY, std::to_string(start));
+  manifest.SetProperty(ycsbc::CoreWorkload::TABLENAME_PROPERTY,
+                       props.GetProperty(ycsbc::CoreWorkload::TABLENAME_PROPERTY,
+                                         ycsbc::CoreWorkload::TABLENAME_DEFAULT));
+  std::ofstream output(ycsbc::BulkManifestPath(dir));
+  output << "# dataset generated by ycsb-gen" << std::endl;
+  manifest.Store(output);
+  output.close();
+  if (output.fail()) {
+    std::cerr << "Failed to write " << ycsbc::BulkManifestPath(dir) << std::endl;
+    exit(1);
+  }
+
+  std::cout << "Generate partitions: " << num_partitions << std::endl;
+  std::cout << "Generate runtime(sec): " << runtime << std::endl;
+  std::cout << "Generate records: " << records << std::endl;
+  std::cout << "Generate throughput(records/sec): " << records / runtime << std::endl;
+
+  delete wl;
+  delete measurements;
+  return 0;
+}
@@ -0,0 +1,122 @@
+//
+//  affinity.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_AFFINITY_H_
+#define YCSB_C_AFFINITY_H_
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "utils.h"
+
+namespace ycsbc {
+
+namespace utils {
+
+///
+/// Parses a cpu list in the kernel's format, e.g. "0-3,8,10-11".
+///
+inline std::vector<int> ParseCpuList(const std::string &list) {
+  std::vector<int> cpus;
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t end = list.find(',', pos);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    std::string range = Trim(list.substr(pos, end - pos));
+    pos = end + 1;
+    if (range.empty()) {
+      continue;
+    }
+    try {
+      size_t dash = range.find('-');
+      int first = std::stoi(range.substr(0, dash));
+      int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+      if (first < 0 || last < first) {
+        throw Exception("Invalid cpu range: " + range);
+      }
+      for (int cpu = first; cpu <= last; cpu++) {
+        cpus.push_back(cpu);
+      }
+    } catch (const std::logic_error &e) {
+      throw Exception("Invalid cpu list: " + list);
+    }
+  }
+  return cpus;
+}
+
+///
+/// Returns the cpus of a NUMA node as reported by sysfs, empty if unknown.
+///
+inline std::vector<int> NumaNodeCpus(int node) {
+  std::ifstream input("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+  std::string list;
+  if (!input.is_open() || !std::getline(input, list)) {
+    return std::vector<int>();
+  }
+  return ParseCpuList(list);
+}
+
+///
+/// Returns the nodes that have cpus attached, empty if unknown.
+///
+inline std::vector<int> NumaNodesWithCpus() {
+  std::ifstream input("/sys/devices/system/node/has_cpu");
+  std::string list;
+  if (!input.is_open() || !std::getline(input, list)) {
+    return std::vector<int>();
+  }
+  return ParseCpuList(list);
+}
+
+///
+/// Returns the online cpus, empty if unknown.
+///
+inline std::vector<int> OnlineCpus() {
+  std::ifstream input("/sys/devices/system/cpu/online");
+  std::string list;
+  if (!input.is_open() || !std::getline(input, list)) {
+    return std::vector<int>();
+  }
+  return ParseCpuList(list);
+}
+
+///
+/// Restricts the calling thread to the given cpus. An empty set is a no-op.
+///
+inline void SetThreadAffinity(const std::vector<int> &cpus) {
+  if (cpus.empty()) {
+    return;
+  }
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu >= CPU_SETSIZE) {
+      throw Exception("cpu out of range: " + std::to_string(cpu));
+    }
+    CPU_SET(cpu, &set);
+  }
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    throw Exception("sched_setaffinity failed");
+  }
+#else
+  throw Exception("thread affinity is not supported on this platform");
+#endif
+}
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_AFFINITY_H_
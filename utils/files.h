@@ -0,0 +1,159 @@
+//
+//  files.h
+//  YCSB-cpp
+//
+//  Copyright (c) 2020 Youngjae Lee <ls4154.lee@gmail.com>.
+//
+
+#ifndef YCSB_C_FILES_H_
+#define YCSB_C_FILES_H_
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils.h"
+
+namespace ycsbc {
+
+namespace utils {
+
+///
+/// Creates a directory, which may already exist.
+///
+inline void MakeDirectory(const std::string &dir) {
+  if (mkdir(dir.c_str(), 0775) && errno != EEXIST) {
+    throw Exception("mkdir " + dir + ": " + strerror(errno));
+  }
+}
+
+///
+/// Names of the regular files in a directory.
+///
+inline std::vector<std::string> ListFiles(const std::string &dir) {
+  DIR *d = opendir(dir.c_str());
+  if (d == nullptr) {
+    throw Exception("opendir " + dir + ": " + strerror(errno));
+  }
+  std::vector<std::string> files;
+  while (struct dirent *entry = readdir(d)) {
+    struct stat st;
+    if (stat((dir + "/" + entry->d_name).c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+      files.push_back(entry->d_name);
+    }
+  }
+  closedir(d);
+  return files;
+}
+
+///
+/// Removes a file, which may not exist.
+///
+inline void RemoveFile(const std::string &path) {
+  if (unlink(path.c_str()) && errno != ENOENT) {
+    throw Exception("unlink " + path + ": " + strerror(errno));
+  }
+}
+
+///
+/// Copies a file, replacing any file at the destination.
+///
+inline void CopyFile(const std::string &from, const std::string &to) {
+  std::ifstream src(from, std::ios::binary);
+  if (!src.is_open()) {
+    throw Exception("failed to open: " + from);
+  }
+  RemoveFile(to);
+  std::ofstream dst(to, std::ios::binary);
+  if (src.peek() != std::ifstream::traits_type::eof()) {
+    dst << src.rdbuf();
+  }
+  dst.close();
+  if (dst.fail()) {
+    throw Exception("failed to copy " + from + " to " + to);
+  }
+}
+
+///
+/// Hard links a file that never changes once written, or copies it if it
+/// cannot be linked, e.g. across file systems.
+///
+inline void LinkOrCopyFile(const std::string &from, const std::string &to) {
+  RemoveFile(to);
+  if (link(from.c_str(), to.c_str())) {
+    CopyFile(from, to);
+  }
+}
+
+///
+/// Removes the regular files of a directory, which may not exist.
+///
+inline void ClearDirectory(const std::string &dir) {
+  struct stat st;
+  if (stat(dir.c_str(), &st) != 0) {
+    return;
+  }
+  for (const std::string &file : ListFiles(dir)) {
+    RemoveFile(dir + "/" + file);
+  }
+}
+
+///
+/// Calls visit with the path and status of every regular file at or below
+/// path, which may be a file, a directory or missing.
+///
+inline void WalkFiles(const std::string &path,
+                      const std::function<void(const std::string &, const struct stat &)> &visit) {
+  struct stat st;
+  if (lstat(path.c_str(), &st) != 0) {
+    return;
+  }
+  if (S_ISREG(st.st_mode)) {
+    visit(path, st);
+  } else if (S_ISDIR(st.st_mode)) {
+    DIR *d = opendir(path.c_str());
+    if (d == nullptr) {
+      return;
+    }
+    while (struct dirent *entry = readdir(d)) {
+      if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+        WalkFiles(path + "/" + entry->d_name, visit);
+      }
+    }
+    closedir(d);
+  }
+}
+
+///
+/// Drops the files at or below path from the OS page cache, writing back
+/// their dirty pages first. Needs no privileges, but pages still mapped by
+/// a process stay. Returns the number of bytes of the files.
+///
+inline uint64_t EvictFromPageCache(const std::string &path) {
+  uint64_t bytes = 0;
+  WalkFiles(path, [&bytes](const std::string &file, const struct stat &st) {
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return;
+    }
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+    bytes += st.st_size;
+  });
+  return bytes;
+}
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_FILES_H_
@@ -28,6 +28,20 @@ class Properties {
   void SetProperty(const std::string &key, const std::string &value);
   bool ContainsKey(const std::string &key) const;
   void Load(std::ifstream &input);
+  ///
+  /// Writes every property as a key=value line, so that Load reads it back.
+  ///
+  void Store(std::ofstream &output) const;
+  ///
+  /// Returns a copy in which each property named prefix + key overrides the
+  /// property named key.
+  ///
+  Properties Overlay(const std::string &prefix) const;
+  ///
+  /// Copies every property of other into this one, named prefix + key, so
+  /// that Overlay(prefix) reads them back.
+  ///
+  void SetPrefixed(const std::string &prefix, const Properties &other);
  private:
   std::map<std::string, std::string> properties_;
 };
@@ -54,6 +68,21 @@ inline bool Properties::ContainsKey(const std::string &key) const {
   return properties_.find(key) != properties_.end();
 }
 
+inline Properties Properties::Overlay(const std::string &prefix) const {
+  Properties p = *this;
+  for (auto it = properties_.lower_bound(prefix);
+       it != properties_.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+    p.properties_[it->first.substr(prefix.size())] = it->second;
+  }
+  return p;
+}
+
+inline void Properties::SetPrefixed(const std::string &prefix, const Properties &other) {
+  for (const auto &kv : other.properties_) {
+    properties_[prefix + kv.first] = kv.second;
+  }
+}
+
 inline void Properties::Load(std::ifstream &input) {
   if (!input.is_open()) {
     throw Exception("File not open!");
@@ -69,6 +98,12 @@ inline void Properties::Load(std::ifstream &input) {
   }
 }
 
+inline void Properties::Store(std::ofstream &output) const {
+  for (const auto &kv : properties_) {
+    output << kv.first << '=' << kv.second << std::endl;
+  }
+}
+
 } // utils
 
 } // ycsbc
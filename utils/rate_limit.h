@@ -9,68 +9,87 @@
 #define YCSB_C_RATE_LIMIT_H_
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
-#include <cstdio>
-#include <mutex>
-#include <ratio>
+#include <cstdint>
 #include <thread>
 
 namespace ycsbc {
 
 namespace utils {
 
-// Token bucket rate limiter for single client
+// Token bucket rate limiter shared by all clients.
+//
+// The bucket is kept as the time at which the next token becomes available
+// (in picoseconds since construction), so that Consume() only needs a single
+// compare-and-swap and an idle client never holds back the others. Waiting is
+// done by sleeping until shortly before the deadline and spinning for the rest,
+// since sleep_for alone overshoots by tens of microseconds.
 class RateLimiter {
  public:
-  RateLimiter(int64_t r, int64_t b) : r_(r * TOKEN_PRECISION), b_(b * TOKEN_PRECISION), tokens_(0), last_(Clock::now()) {}
+  RateLimiter(int64_t r, int64_t b) : interval_(Interval(r)), burst_(std::max<int64_t>(1, b)),
+                                      next_(0), consumed_(0), start_(Clock::now()) {}
 
   inline void Consume(int64_t n) {
-    std::unique_lock<std::mutex> lock(mutex_);
-
-    if (r_ <= 0) {
+    int64_t interval = interval_.load(std::memory_order_relaxed);
+    if (interval <= 0) {
+      consumed_.fetch_add(n, std::memory_order_relaxed);
       return;
     }
 
-    // refill tokens
-    auto now = Clock::now();
-    auto diff = std::chrono::duration_cast<Duration>(now - last_);
-    tokens_ = std::min(b_, tokens_ + diff.count() * r_ / 1000000000);
-    last_ = now;
-
-    // check tokens
-    tokens_ -= n * TOKEN_PRECISION;
-
-    // sleep
-    if (tokens_ < 0) {
-      lock.unlock();
-      int64_t wait_time = -tokens_ * 1000000000 / r_;
-      std::this_thread::sleep_for(std::chrono::nanoseconds(wait_time));
+    // reserve n tokens, refilling at most burst tokens since the last reservation
+    int64_t now = Now();
+    int64_t next = next_.load(std::memory_order_relaxed);
+    int64_t start;
+    do {
+      start = std::max(next, now - burst_ * interval);
+    } while (!next_.compare_exchange_weak(next, start + n * interval, std::memory_order_relaxed));
+    consumed_.fetch_add(n, std::memory_order_relaxed);
+
+    // wait until the last reserved token is available
+    int64_t deadline = start + (n - 1) * interval;
+    int64_t wait = deadline - now;
+    if (wait > SPIN_THRESHOLD) {
+      std::this_thread::sleep_for(std::chrono::nanoseconds((wait - SPIN_THRESHOLD) / 1000));
+    }
+    while (Now() < deadline) {
+      std::this_thread::yield();
     }
   }
 
   inline void SetRate(int64_t r) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    interval_.store(Interval(r), std::memory_order_relaxed);
+  }
 
-    // refill tokens
-    auto now = Clock::now();
-    auto diff = std::chrono::duration_cast<Duration>(now - last_);
-    tokens_ = std::min(b_, tokens_ + diff.count() * r_ * TOKEN_PRECISION / 1000000000);
-    last_ = now;
+  // current rate in ops per second, 0 if unlimited
+  inline double GetRate() const {
+    int64_t interval = interval_.load(std::memory_order_relaxed);
+    return interval > 0 ? 1e12 / interval : 0;
+  }
 
-    // set rate
-    r_ = r * TOKEN_PRECISION;
+  // number of tokens handed out so far
+  inline uint64_t GetConsumed() const {
+    return consumed_.load(std::memory_order_relaxed);
   }
 
  private:
   using Clock = std::chrono::steady_clock;
-  using Duration = std::chrono::nanoseconds;
-  static constexpr int64_t TOKEN_PRECISION = 10000;
-
-  std::mutex mutex_;
-  int64_t r_;
-  int64_t b_;
-  int64_t tokens_;
-  Clock::time_point last_;
+  // remaining wait below which the pacer spins instead of sleeping, in picoseconds
+  static constexpr int64_t SPIN_THRESHOLD = 100000000;
+
+  static int64_t Interval(int64_t r) {
+    return r > 0 ? std::max<int64_t>(1, 1000000000000 / r) : 0;
+  }
+
+  inline int64_t Now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_).count() * 1000;
+  }
+
+  std::atomic<int64_t> interval_;
+  const int64_t burst_;
+  std::atomic<int64_t> next_;
+  std::atomic<uint64_t> consumed_;
+  const Clock::time_point start_;
 };
 
 } // utils
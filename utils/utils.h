@@ -57,7 +57,8 @@ inline uint32_t ThreadLocalRandomInt() {
 inline double ThreadLocalRandomDouble(double min = 0.0, double max = 1.0) {
   static thread_local std::random_device rd;
   static thread_local std::minstd_rand rn(rd());
-  static thread_local std::uniform_real_distribution<double> uniform(min, max);
+  // not thread_local, the range differs between callers
+  std::uniform_real_distribution<double> uniform(min, max);
   return uniform(rn);
 }
 
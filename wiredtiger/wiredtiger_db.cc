@@ -13,8 +13,10 @@
 #define mkdir(x, y) _mkdir(x)
 #endif
 
+#include "core/bulk_file.h"
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "utils/files.h"
 #include "utils/utils.h"
 
 #include "wiredtiger_db.h"
@@ -45,6 +47,9 @@ namespace {
   const std::string PROP_IN_MEMORY = WT_PREFIX ".in_memory";
   const std::string PROP_IN_MEMORY_DEFAULT = "false";
 
+  const std::string PROP_STATISTICS = WT_PREFIX ".statistics";
+  const std::string PROP_STATISTICS_DEFAULT = "none";
+
   const std::string PROP_LSM_MGR_MERGE = WT_PREFIX ".lsm_mgr.merge";
   const std::string PROP_LSM_MGR_MERGE_DEFAULT = "true";
 
@@ -85,6 +90,7 @@ namespace {
 namespace ycsbc {
 
 WT_CONNECTION* WTDB::conn_ = nullptr;
+std::unordered_map<std::string, std::string> WTDB::table_uris_;
 int WTDB::ref_cnt_ = 0;
 std::mutex WTDB::mu_;
 
@@ -93,8 +99,6 @@ void WTDB::Init(){
 
   const utils::Properties &props = *props_;
   const std::string &format = props.GetProperty(PROP_FORMAT, PROP_FORMAT_DEFAULT);
-  fieldcount_ = std::stoi(props.GetProperty(CoreWorkload::FIELD_COUNT_PROPERTY,
-                                            CoreWorkload::FIELD_COUNT_DEFAULT));
 
   if(format=="single"){
     method_read_ = &WTDB::ReadSingleEntry;
@@ -109,7 +113,7 @@ void WTDB::Init(){
   ref_cnt_++;
   if(conn_){
     error_check(conn_->open_session(conn_, NULL, NULL, &session_));
-    error_check(session_->open_cursor(session_, "table:ycsbc", NULL, "overwrite=true", &cursor_));
+    OpenCursors();
     return;
   }
 
@@ -131,9 +135,11 @@ void WTDB::Init(){
       const std::string &cache_size = props.GetProperty(PROP_CACHE_SIZE, PROP_CACHE_SIZE_DEFAULT);
       const std::string &direct_io = props.GetProperty(PROP_DIRECT_IO, PROP_DIRECT_IO_DEFAULT);
       const std::string &in_memory = props.GetProperty(PROP_IN_MEMORY, PROP_IN_MEMORY_DEFAULT);
+      const std::string &statistics = props.GetProperty(PROP_STATISTICS, PROP_STATISTICS_DEFAULT);
       if(!cache_size.empty()) db_config += "cache_size="+ cache_size+ ",";
       if(!direct_io.empty())  db_config += "direct_io=" + direct_io + ",";
       if(!in_memory.empty())  db_config += "in_memory=" + in_memory + ",";
+      if(!statistics.empty()) db_config += "statistics=(" + statistics + "),";
     }
     { // 2.2 LSM Manager
       std::string lsm_config;
@@ -187,37 +193,74 @@ void WTDB::Init(){
       if(!leaf_page_max.empty())      table_config += "leaf_page_max=" + leaf_page_max;
     }
     std::cout<<"table config: "<<table_config<<std::endl;
-    error_check(session_->create(session_, "table:ycsbc", table_config.c_str()));
+
+    // a single table keeps its old name, a list of tables gets one WiredTiger table each
+    table_uris_.clear();
+    if (props.GetProperty(CoreWorkload::TABLES_PROPERTY).empty()) {
+      table_uris_[CoreWorkload::GetTableNames(props)[0]] = "table:ycsbc";
+    } else {
+      for (const std::string &table : CoreWorkload::GetTableNames(props)) {
+        table_uris_[table] = "table:" + table;
+      }
+    }
+    for (auto &table : table_uris_) {
+      error_check(session_->create(session_, table.second.c_str(), table_config.c_str()));
+    }
+  }
+
+  // Open cursors (per thread)
+  OpenCursors();
+}
+
+void WTDB::OpenCursors(){
+  for (auto &table : table_uris_) {
+    WT_CURSOR *cursor;
+    error_check(session_->open_cursor(session_, table.second.c_str(), NULL, "overwrite=true", &cursor));
+    cursors_[table.first] = cursor;
   }
+}
 
-  // Open cursor (per thread)
-  error_check(session_->open_cursor(session_, "table:ycsbc", NULL, "overwrite=true", &cursor_));
+WT_CURSOR *WTDB::Cursor(const std::string &table){
+  // with a single table, any table name maps to it as before
+  if (cursors_.size() == 1) {
+    return cursors_.begin()->second;
+  }
+  auto it = cursors_.find(table);
+  if (it == cursors_.end()) {
+    throw utils::Exception(WT_PREFIX " unknown table: " + table);
+  }
+  return it->second;
 }
 
 void WTDB::Cleanup(){
   const std::lock_guard<std::mutex> lock(mu_);
-  cursor_->close(cursor_);
+  for (auto &cursor : cursors_) {
+    cursor.second->close(cursor.second);
+  }
+  cursors_.clear();
   error_check(session_->close(session_, NULL));
   if (--ref_cnt_) {
     return;
   }
   error_check(conn_->close(conn_, NULL));
+  conn_ = nullptr;
 }
 
 DB::Status WTDB::ReadSingleEntry(const std::string &table, const std::string &key,
                                       const std::vector<std::string> *fields,
                                       std::vector<Field> &result) {
+  WT_CURSOR *cursor = Cursor(table);
   WT_ITEM k = {key.data(), key.size()};
   WT_ITEM v;
   int ret;
-  cursor_->set_key(cursor_, &k);
-  ret = cursor_->search(cursor_);
+  cursor->set_key(cursor, &k);
+  ret = cursor->search(cursor);
   if(ret==WT_NOTFOUND){
     return kNotFound;
   } else if(ret != 0) {
     throw utils::Exception(WT_PREFIX " search error");
   }
-  error_check(cursor_->get_value(cursor_, &v));
+  error_check(cursor->get_value(cursor, &v));
   if (fields != nullptr) {
     DeserializeRowFilter(&result, (const char*)v.data, v.size, *fields);
   } else {
@@ -229,17 +272,18 @@ DB::Status WTDB::ReadSingleEntry(const std::string &table, const std::string &ke
 DB::Status WTDB::ScanSingleEntry(const std::string &table, const std::string &key, int len,
                                       const std::vector<std::string> *fields,
                                       std::vector<std::vector<Field>> &result) {
+  WT_CURSOR *cursor = Cursor(table);
   WT_ITEM k = {key.data(), key.size()};
   WT_ITEM v;
   int ret = 0, exact;
 
-  cursor_->set_key(cursor_, &k);
-  error_check(cursor_->search_near(cursor_, &exact));
+  cursor->set_key(cursor, &k);
+  error_check(cursor->search_near(cursor, &exact));
   if (exact < 0) {
-    ret = cursor_->next(cursor_);
+    ret = cursor->next(cursor);
   }
   for(int i=0; !ret && i<len; ++i){
-    error_check(cursor_->get_value(cursor_, &v));
+    error_check(cursor->get_value(cursor, &v));
     result.emplace_back(std::vector<Field>());
     if (fields != nullptr) {
       DeserializeRowFilter(&result.back(), (const char*)v.data, v.size, *fields);
@@ -252,19 +296,20 @@ DB::Status WTDB::ScanSingleEntry(const std::string &table, const std::string &ke
 
 DB::Status WTDB::UpdateSingleEntry(const std::string &table, const std::string &key,
                            std::vector<Field> &values){
+  WT_CURSOR *cursor = Cursor(table);
   std::vector<Field> current_values;
   WT_ITEM k = {key.data(), key.size()};
   WT_ITEM v;
   int ret;
 
-  cursor_->set_key(cursor_, &k);
-  ret = cursor_->search(cursor_);
+  cursor->set_key(cursor, &k);
+  ret = cursor->search(cursor);
   if(ret==WT_NOTFOUND){
     return kNotFound;
   } else if(ret != 0) {
     throw utils::Exception(WT_PREFIX " search error");
   }
-  error_check(cursor_->get_value(cursor_, &v));
+  error_check(cursor->get_value(cursor, &v));
   DeserializeRow(&current_values, (const char*)v.data, v.size);
   for (Field &new_field : values) {
     bool found MAYBE_UNUSED = false;
@@ -282,8 +327,8 @@ DB::Status WTDB::UpdateSingleEntry(const std::string &table, const std::string &
   SerializeRow(current_values, &data);
   v.data = data.data();
   v.size = data.size();
-  cursor_->set_value(cursor_, &v);
-  ret = cursor_->update(cursor_);
+  cursor->set_value(cursor, &v);
+  ret = cursor->update(cursor);
   if(ret==WT_NOTFOUND){
     return kNotFound;
   } else if(ret != 0) {
@@ -294,25 +339,148 @@ DB::Status WTDB::UpdateSingleEntry(const std::string &table, const std::string &
 
 DB::Status WTDB::InsertSingleEntry(const std::string &table, const std::string &key,
                            std::vector<Field> &values){
+  WT_CURSOR *cursor = Cursor(table);
   std::string data;
   WT_ITEM k = {key.data(), key.size()}, v;
   
-  cursor_->set_key(cursor_, &k);
+  cursor->set_key(cursor, &k);
   SerializeRow(values, &data);
   v.data = data.data();
   v.size = data.size();
-  cursor_->set_value(cursor_, &v);
-  error_check(cursor_->insert(cursor_));
+  cursor->set_value(cursor, &v);
+  error_check(cursor->insert(cursor));
   // TODO: cursor reset?
   return kOK;
 }
 DB::Status WTDB::DeleteSingleEntry(const std::string &table, const std::string &key){
+  WT_CURSOR *cursor = Cursor(table);
   WT_ITEM k = {key.data(), key.size()};
-  cursor_->set_key(cursor_, &k);
-  error_check(cursor_->remove(cursor_));
+  cursor->set_key(cursor, &k);
+  error_check(cursor->remove(cursor));
+  return kOK;
+}
+
+DB::Status WTDB::ScanAll(const std::string &table, const ScanVisitor &visit) {
+  WT_CURSOR *cursor = Cursor(table);
+  WT_ITEM k, v;
+
+  // one snapshot for the whole scan, which keeps the versions it may read in cache
+  error_check(session_->begin_transaction(session_, "isolation=snapshot"));
+  int ret = cursor->next(cursor);
+  while (!ret) {
+    error_check(cursor->get_key(cursor, &k));
+    error_check(cursor->get_value(cursor, &v));
+    if (!visit(k.size + v.size)) {
+      break;
+    }
+    ret = cursor->next(cursor);
+  }
+  cursor->reset(cursor);
+  error_check(session_->rollback_transaction(session_, NULL));
+  if (ret && ret != WT_NOTFOUND) {
+    error_check(ret);
+  }
   return kOK;
 }
 
+DB::Status WTDB::BatchWrite(const std::string &table, std::vector<Mutation> &batch){
+  WT_CURSOR *cursor = Cursor(table);
+  std::string data;
+  error_check(session_->begin_transaction(session_, NULL));
+  for (Mutation &m : batch) {
+    WT_ITEM k = {m.key.data(), m.key.size()}, v;
+    cursor->set_key(cursor, &k);
+    int ret;
+    if (m.type == Mutation::kInsert) {
+      data.clear();
+      SerializeRow(m.values, &data);
+      v.data = data.data();
+      v.size = data.size();
+      cursor->set_value(cursor, &v);
+      ret = cursor->insert(cursor);
+    } else {
+      ret = cursor->remove(cursor);
+      if (ret == WT_NOTFOUND) {
+        ret = 0;
+      }
+    }
+    if (ret != 0) {
+      session_->rollback_transaction(session_, NULL);
+      error_check(ret);
+    }
+  }
+  error_check(session_->commit_transaction(session_, NULL));
+  return kOK;
+}
+
+// snapshot isolation, a write that conflicts with a concurrent transaction
+// fails with WT_ROLLBACK
+class WTDB::WTTransaction : public DB::Transaction {
+ public:
+  WTTransaction(WTDB *owner, WT_CURSOR *cursor) : owner_(owner), cursor_(cursor) {}
+
+  Status Read(const std::string &key, const std::vector<std::string> *fields,
+              std::vector<Field> &result) {
+    WT_CURSOR *cursor = cursor_;
+    WT_ITEM k = {key.data(), key.size()};
+    WT_ITEM v;
+    cursor->set_key(cursor, &k);
+    int ret = cursor->search(cursor);
+    if(ret==WT_NOTFOUND){
+      return kNotFound;
+    } else if(ret==WT_ROLLBACK){
+      return kAborted;
+    }
+    error_check(ret);
+    error_check(cursor->get_value(cursor, &v));
+    if (fields != nullptr) {
+      owner_->DeserializeRowFilter(&result, (const char*)v.data, v.size, *fields);
+    } else {
+      owner_->DeserializeRow(&result, (const char*)v.data, v.size);
+    }
+    return kOK;
+  }
+
+  Status Write(const std::string &key, std::vector<Field> &values) {
+    WT_CURSOR *cursor = cursor_;
+    std::string data;
+    WT_ITEM k = {key.data(), key.size()}, v;
+    cursor->set_key(cursor, &k);
+    owner_->SerializeRow(values, &data);
+    v.data = data.data();
+    v.size = data.size();
+    cursor->set_value(cursor, &v);
+    int ret = cursor->insert(cursor);
+    if(ret==WT_ROLLBACK){
+      return kAborted;
+    }
+    error_check(ret);
+    return kOK;
+  }
+
+  Status Commit() {
+    // a failed commit rolls the transaction back
+    int ret = owner_->session_->commit_transaction(owner_->session_, NULL);
+    if (ret == 0) {
+      return kOK;
+    }
+    return ret == WT_ROLLBACK ? kAborted : kError;
+  }
+
+  void Rollback() {
+    owner_->session_->rollback_transaction(owner_->session_, NULL);
+  }
+
+ private:
+  WTDB *owner_;
+  WT_CURSOR *cursor_;
+};
+
+DB::Transaction *WTDB::BeginTransaction(const std::string &table){
+  error_check(session_->begin_transaction(session_, "isolation=snapshot"));
+  return new WTTransaction(this, Cursor(table));
+}
+
 void WTDB::SerializeRow(const std::vector<Field> &values, std::string *data) {
   for (const Field &field : values) {
     uint32_t len = field.name.size();
@@ -339,7 +507,6 @@ void WTDB::DeserializeRow(std::vector<Field> *values, const char *data_ptr, size
     p += len;
     values->push_back({field, value});
   }
-  assert(values->size() == fieldcount_);
 }
 
 void WTDB::DeserializeRowFilter(std::vector<Field> *values, const char *data_ptr, size_t data_len,
@@ -365,6 +532,124 @@ void WTDB::DeserializeRowFilter(std::vector<Field> *values, const char *data_ptr
   assert(values->size() == fields.size());
 }
 
+DB::Status WTDB::Checkpoint(const std::string &dir) {
+  const std::string &home = props_->GetProperty(PROP_HOME, PROP_HOME_DEFAULT);
+  utils::MakeDirectory(dir);
+  // files stay consistent while the backup cursor is open
+  WT_CURSOR *cursor;
+  error_check(session_->open_cursor(session_, "backup:", NULL, NULL, &cursor));
+  int ret;
+  while ((ret = cursor->next(cursor)) == 0) {
+    const char *file;
+    error_check(cursor->get_key(cursor, &file));
+    utils::CopyFile(home + "/" + file, dir + "/" + file);
+  }
+  if (ret != WT_NOTFOUND) {
+    error_check(ret);
+  }
+  error_check(cursor->close(cursor));
+  return kOK;
+}
+
+DB::Status WTDB::Restore(const std::string &dir) {
+  const std::lock_guard<std::mutex> lock(mu_);
+  if (conn_) {
+    throw utils::Exception(WT_PREFIX " Restore: the connection is open");
+  }
+  const std::string &home = props_->GetProperty(PROP_HOME, PROP_HOME_DEFAULT);
+  if (home.empty()) {
+    throw utils::Exception(WT_PREFIX " home is missing");
+  }
+  utils::ClearDirectory(home);
+  utils::MakeDirectory(home);
+  for (const std::string &file : utils::ListFiles(dir)) {
+    utils::CopyFile(dir + "/" + file, home + "/" + file);
+  }
+  return kOK;
+}
+
+DB::Status WTDB::BulkLoad(const std::string &table, const std::vector<std::string> &files) {
+  // a bulk cursor needs the table to itself, so set this handle's cursor aside
+  std::string table_name = table;
+  auto it = cursors_.find(table);
+  if (cursors_.size() == 1) {
+    it = cursors_.begin();
+    table_name = it->first;
+  }
+  if (it == cursors_.end()) {
+    throw utils::Exception(WT_PREFIX " unknown table: " + table);
+  }
+  error_check(it->second->close(it->second));
+  cursors_.erase(it);
+
+  // keys arrive in order, so pages are built bottom-up without a search
+  WT_CURSOR *bulk;
+  error_check(session_->open_cursor(session_, table_uris_.at(table_name).c_str(), NULL, "bulk", &bulk));
+  std::string key;
+  std::vector<Field> values;
+  std::string data;
+  for (const std::string &file : files) {
+    BulkFileReader reader;
+    reader.Open(file);
+    while (reader.Next(key, values)) {
+      data.clear();
+      SerializeRow(values, &data);
+      WT_ITEM k = {key.data(), key.size()};
+      WT_ITEM v = {data.data(), data.size()};
+      bulk->set_key(bulk, &k);
+      bulk->set_value(bulk, &v);
+      error_check(bulk->insert(bulk));
+    }
+  }
+  error_check(bulk->close(bulk));
+
+  WT_CURSOR *cursor;
+  error_check(session_->open_cursor(session_, table_uris_.at(table_name).c_str(), NULL, "overwrite=true", &cursor));
+  cursors_[table_name] = cursor;
+  return kOK;
+}
+
+std::vector<std::string> WTDB::GetDataPaths() {
+  return {props_->GetProperty(PROP_HOME, PROP_HOME_DEFAULT)};
+}
+
+DB::Status WTDB::GetStats(std::vector<Field> &stats) {
+  const std::lock_guard<std::mutex> lock(mu_);
+  if (conn_ == nullptr) {
+    return kError;
+  }
+  // sessions are single-threaded, so the sampler opens one of its own
+  WT_SESSION *session;
+  error_check(conn_->open_session(conn_, NULL, NULL, &session));
+  WT_CURSOR *cursor;
+  if (session->open_cursor(session, "statistics:", NULL, NULL, &cursor) != 0) {
+    // statistics=(none)
+    error_check(session->close(session, NULL));
+    return kNotImplemented;
+  }
+  const std::pair<int, const char *> counters[] = {
+    {WT_STAT_CONN_CACHE_BYTES_INUSE, "wiredtiger.cache.bytes_inuse"},
+    {WT_STAT_CONN_CACHE_BYTES_DIRTY, "wiredtiger.cache.bytes_dirty"},
+    {WT_STAT_CONN_CACHE_READ, "wiredtiger.cache.pages_read"},
+    {WT_STAT_CONN_CACHE_WRITE, "wiredtiger.cache.pages_written"},
+    {WT_STAT_CONN_BLOCK_BYTE_READ, "wiredtiger.block.bytes_read"},
+    {WT_STAT_CONN_BLOCK_BYTE_WRITE, "wiredtiger.block.bytes_written"},
+    {WT_STAT_CONN_TXN_CHECKPOINT_RUNNING, "wiredtiger.checkpoint.running"},
+  };
+  for (const auto &counter : counters) {
+    cursor->set_key(cursor, counter.first);
+    const char *desc;
+    const char *pvalue;
+    int64_t value;
+    if (cursor->search(cursor) == 0 && cursor->get_value(cursor, &desc, &pvalue, &value) == 0) {
+      stats.push_back({counter.second, std::to_string(value)});
+    }
+  }
+  error_check(cursor->close(cursor));
+  error_check(session->close(session, NULL));
+  return kOK;
+}
+
 DB *NewWTDB() {
   return new WTDB;
 }
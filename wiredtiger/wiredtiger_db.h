@@ -6,6 +6,7 @@
 
 #include <string>
 #include <mutex>
+#include <unordered_map>
 
 #include "core/db.h"
 #include "utils/properties.h"
@@ -46,7 +47,24 @@ class WTDB : public DB {
     return (this->*(method_delete_))(table, key);
   }
 
+  Status ScanAll(const std::string &table, const ScanVisitor &visit);
+
+  Status BatchWrite(const std::string &table, std::vector<Mutation> &batch);
+
+  Transaction *BeginTransaction(const std::string &table);
+
+  Status Checkpoint(const std::string &dir);
+
+  Status Restore(const std::string &dir);
+
+  Status BulkLoad(const std::string &table, const std::vector<std::string> &files);
+
+  std::vector<std::string> GetDataPaths();
+
+  Status GetStats(std::vector<Field> &stats);
+
  private:
+  class WTTransaction;
 
   Status ReadSingleEntry(const std::string &table, const std::string &key,
                          const std::vector<std::string> *fields, std::vector<Field> &result);
@@ -74,11 +92,14 @@ class WTDB : public DB {
                                       std::vector<Field> &);
   Status (WTDB::*method_delete_)(const std::string &, const std::string &);
   
-  unsigned fieldcount_;
+  void OpenCursors();
+  WT_CURSOR *Cursor(const std::string &table);
 
   static WT_CONNECTION *conn_;
+  // uri of each table
+  static std::unordered_map<std::string, std::string> table_uris_;
   WT_SESSION *session_{nullptr};
-  WT_CURSOR *cursor_{nullptr};
+  std::unordered_map<std::string, WT_CURSOR *> cursors_;
 
   static int ref_cnt_;
   static std::mutex mu_;